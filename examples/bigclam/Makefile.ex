@@ -3,7 +3,7 @@
 
 ## Main application file
 MAIN = bigclam
-DEPH = $(EXSNAPADV)/agm.h $(EXSNAPADV)/agmfit.h $(EXSNAPADV)/agmfast.h
-DEPCPP = $(EXSNAPADV)/agm.cpp $(EXSNAPADV)/agmfit.cpp $(EXSNAPADV)/agmfast.cpp
+DEPH = $(EXSNAPADV)/agm.h $(EXSNAPADV)/agmfit.h $(EXSNAPADV)/agmfast.h $(EXSNAPADV)/agmfastsp.h
+DEPCPP = $(EXSNAPADV)/agm.cpp $(EXSNAPADV)/agmfit.cpp $(EXSNAPADV)/agmfast.cpp $(EXSNAPADV)/agmfastsp.cpp
 CXXFLAGS += $(CXXOPENMP)
 
@@ -2,6 +2,7 @@
 //
 #include "stdafx.h"
 #include "agmfast.h"
+#include "agmfastsp.h"
 #include "agm.h"
 #ifdef USE_OPENMP
 #include <omp.h>
@@ -22,6 +23,8 @@ int main(int argc, char* argv[]) {
   const int NumThreads = Env.GetIfArgPrefixInt("-nt:", 4, "Number of threads for parallelization");
   const double StepAlpha = Env.GetIfArgPrefixFlt("-sa:", 0.05, "Alpha for backtracking line search");
   const double StepBeta = Env.GetIfArgPrefixFlt("-sb:", 0.3, "Beta for backtracking line search");
+  const bool SparseRows = Env.IsArgStr("-sp", "Use the sparse-row solver with lock-free parallel updates");
+  const bool Bench = Env.IsArgStr("-bench", "Run both solvers from the same initialization and report node updates/sec");
 
 #ifdef USE_OPENMP
   omp_set_num_threads(NumThreads);
@@ -40,7 +43,7 @@ int main(int argc, char* argv[]) {
   } else {
     G = TAGMUtil::LoadEdgeListStr<PUNGraph>(InFNm, NIDNameH);
   }
-  printf("Graph: %d Nodes %d Edges\n", G->GetNodes(), G->GetEdges());
+  printf("Graph: %d Nodes %d Edges\n", (int) G->GetNodes(), (int) G->GetEdges());
   
   TVec<TIntV> EstCmtyVV;
   TExeTm RunTm;
@@ -51,13 +54,42 @@ int main(int argc, char* argv[]) {
     OptComs = RAGM.FindComsByCV(NumThreads, MaxComs, MinComs, DivComs, OutFPrx, StepAlpha, StepBeta);
   }
 
-  RAGM.NeighborComInit(OptComs);
-  if (NumThreads == 1 || G->GetEdges() < 1000) {
-    RAGM.MLEGradAscent(0.0001, 1000 * G->GetNodes(), "", StepAlpha, StepBeta);
+  if (Bench) {
+    // hash-row solver
+    RAGM.NeighborComInit(OptComs);
+    uint64 StartMSecs = TTm::GetCurUniMSecs();
+    int64 Updates;
+    if (NumThreads == 1 || G->GetEdges() < 1000) {
+      Updates = RAGM.MLEGradAscent(0.0001, 1000 * G->GetNodes(), "", StepAlpha, StepBeta);
+    } else {
+      const int ChunkSize = TMath::Mx((int) (G->GetNodes() / 10 / NumThreads), 1);
+      Updates = (int64) RAGM.MLEGradAscentParallel(0.0001, 1000, NumThreads, ChunkSize, "", StepAlpha, StepBeta) * ChunkSize * NumThreads;
+    }
+    double Secs = TMath::Mx(TTm::GetCurUniMSecs() - StartMSecs, (uint64) 1) / 1000.0;
+    printf("hash rows: %.0f node updates in %.2f sec, %.0f updates/sec, likelihood %f\n",
+      (double) Updates, Secs, Updates / Secs, RAGM.Likelihood());
+    // sparse-row solver
+    TAGMFastSp SpAGM(G, 10, 10);
+    SpAGM.NeighborComInit(OptComs);
+    SpAGM.MLEGradAscent(0.0001, 1000, "", StepAlpha, StepBeta);
+    printf("sparse rows: %.0f node updates in %.2f sec, %.0f updates/sec, likelihood %f\n",
+      (double) SpAGM.GetNodeUpdates(), SpAGM.GetNodeUpdates() / SpAGM.GetUpdatesPerSec(),
+      SpAGM.GetUpdatesPerSec(), SpAGM.Likelihood());
+    SpAGM.GetCmtyVV(EstCmtyVV);
+  } else if (SparseRows) {
+    TAGMFastSp SpAGM(G, 10, 10);
+    SpAGM.NeighborComInit(OptComs);
+    SpAGM.MLEGradAscent(0.0001, 1000, "", StepAlpha, StepBeta);
+    SpAGM.GetCmtyVV(EstCmtyVV);
   } else {
-    RAGM.MLEGradAscentParallel(0.0001, 1000, NumThreads, "", StepAlpha, StepBeta);
+    RAGM.NeighborComInit(OptComs);
+    if (NumThreads == 1 || G->GetEdges() < 1000) {
+      RAGM.MLEGradAscent(0.0001, 1000 * G->GetNodes(), "", StepAlpha, StepBeta);
+    } else {
+      RAGM.MLEGradAscentParallel(0.0001, 1000, NumThreads, "", StepAlpha, StepBeta);
+    }
+    RAGM.GetCmtyVV(EstCmtyVV);
   }
-  RAGM.GetCmtyVV(EstCmtyVV);
   TAGMUtil::DumpCmtyVV(OutFPrx + "cmtyvv.txt", EstCmtyVV, NIDNameH);
   TAGMUtil::SaveGephi(OutFPrx + "graph.gexf", G, EstCmtyVV, 1.5, 1.5, NIDNameH);
 
@@ -60,6 +60,11 @@ int main(int argc, char* argv[]) {
   fprintf(F, "Loglikelihood\t%10.2f\n", KronLL.CalcApxGraphLL());
 //  fprintf(F, "Absolute error (based on expected number of edges)\t%f\n", KronLL.GetAbsErr());
   fprintf(F, "RunTime\t%g\n", ExeTm.GetSecs());
+  const TFltV& StepTmV = KronLL.GetStepTmHist();
+  fprintf(F, "EM iteration time (sec)");
+  for (int i = 0; i < StepTmV.Len(); i++) {
+    fprintf(F, "\t%.2f", StepTmV[i]()); }
+  fprintf(F, "\n");
   fprintf(F, "Estimated initiator\t%s\n", FitMtx.GetMtxStr().CStr());
   fclose(F);
 
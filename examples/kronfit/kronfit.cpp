@@ -21,6 +21,7 @@ int main(int argc, char* argv[]) {
   //const TInt GradType = Env.GetIfArgPrefixInt("-gt:", 1, "1:Grad1, 2:Grad2");
   const bool ScaleInitMtx = Env.GetIfArgPrefixBool("-sim:", true, "Scale the initiator to match the number of edges");
   const TFlt PermSwapNodeProb = Env.GetIfArgPrefixFlt("-nsp:", 1.0, "Probability of using NodeSwap (vs. EdgeSwap) MCMC proposal distribution");
+  const TInt Chains = Env.GetIfArgPrefixInt("-c:", 1, "Number of permutation chains sampled in parallel");
   if (OutFNm.Empty()) { OutFNm = TStr::Fmt("%s-fit%d", InFNm.GetFMid().CStr(), NZero()); }
   // load graph
   PNGraph G;
@@ -40,6 +41,7 @@ int main(int argc, char* argv[]) {
   KronLL.InitLL(G, InitKronMtx);
   InitKronMtx.Dump("SCALED PARAM", true);
   KronLL.SetPerm(Perm.GetCh(0));
+  KronLL.SetChains(Chains);
   double LogLike = 0;
   //if (GradType == 1) {
   LogLike = KronLL.GradDescent(GradIter, LrnRate, MnStep, MxStep, WarmUp, NSamples);
@@ -56,6 +58,11 @@ int main(int argc, char* argv[]) {
   fprintf(F, "Loglikelihood\t%10.2f\n", LogLike);
   fprintf(F, "Absolute error (based on expected number of edges)\t%f\n", KronLL.GetAbsErr());
   fprintf(F, "RunTime\t%g\n", ExeTm.GetSecs());
+  const TFltV& StepTmV = KronLL.GetStepTmHist();
+  fprintf(F, "Gradient step time (sec)");
+  for (int i = 0; i < StepTmV.Len(); i++) {
+    fprintf(F, "\t%.2f", StepTmV[i]()); }
+  fprintf(F, "\n");
   fprintf(F, "Estimated initiator\t%s\n", FitMtx.GetMtxStr().CStr());
   fclose(F);
 
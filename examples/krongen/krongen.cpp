@@ -10,6 +10,7 @@ int main(int argc, char* argv[]) {
   const TStr MtxNm = Env.GetIfArgPrefixStr("-m:", "0.9 0.5; 0.5 0.1", "Matrix (in Maltab notation)");
   const int NIter = Env.GetIfArgPrefixInt("-i:", 5, "Iterations of Kronecker product");
   const int Seed = Env.GetIfArgPrefixInt("-s:", 0, "Random seed (0 - time seed)");
+  const int Shards = Env.GetIfArgPrefixInt("-b:", 0, "Generate in parallel and save edges into binary shards <-o:>.<shard>.bin (0 - text edge list)");
 
   TKronMtx SeedMtx = TKronMtx::GetMtx(MtxNm);
   printf("\n*** Seed matrix:\n");
@@ -17,10 +18,18 @@ int main(int argc, char* argv[]) {
   printf("\n*** Kronecker:\n");
   // slow but exact O(n^2) algorightm
   //PNGraph Graph = TKronMtx::GenKronecker(SeedMtx, NIter, true, Seed); 
-  // fast O(e) approximate algorithm
-  PNGraph Graph = TKronMtx::GenFastKronecker(SeedMtx, NIter, true, Seed); 
-  // save edge list
-  TSnap::SaveEdgeList(Graph, OutFNm, TStr::Fmt("Kronecker Graph: seed matrix [%s]", MtxNm.CStr()));
+  if (Shards > 0) {
+    // fast O(e) approximate algorithm, in parallel
+    TVec<TIntPr, int64> EdgeV;
+    TKronMtx::GenParFastKronecker(SeedMtx, NIter, -1, true, Seed, EdgeV);
+    // save binary edge shards
+    TKronMtx::SaveEdgeShards(EdgeV, OutFNm, Shards);
+  } else {
+    // fast O(e) approximate algorithm
+    PNGraph Graph = TKronMtx::GenFastKronecker(SeedMtx, NIter, true, Seed); 
+    // save edge list
+    TSnap::SaveEdgeList(Graph, OutFNm, TStr::Fmt("Kronecker Graph: seed matrix [%s]", MtxNm.CStr()));
+  }
   Catch
   printf("\nrun time: %s (%s)\n", ExeTm.GetTmStr(), TSecTm::GetCurTm().GetTmStr().CStr());
   return 0;
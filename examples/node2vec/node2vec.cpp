@@ -8,7 +8,8 @@
 
 void ParseArgs(int& argc, char* argv[], TStr& InFile, TStr& OutFile,
  int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter,
- bool& Verbose, double& ParamP, double& ParamQ, bool& Directed, bool& Weighted) {
+ bool& Verbose, double& ParamP, double& ParamQ, bool& Directed, bool& Weighted,
+ int64& MemBudget, TStr& WalkFile) {
   Env = TEnv(argc, argv, TNotify::StdNotify);
   Env.PrepArgs(TStr::Fmt("\nAn algorithmic framework for representational learning on graphs."));
   InFile = Env.GetIfArgPrefixStr("-i:", "graph/karate.edgelist",
@@ -29,6 +30,11 @@ void ParseArgs(int& argc, char* argv[], TStr& InFile, TStr& OutFile,
    "Return hyperparameter. Default is 1");
   ParamQ = Env.GetIfArgPrefixFlt("-q:", 1,
    "Inout hyperparameter. Default is 1");
+  MemBudget = Env.GetIfArgPrefixInt("-m:", -1,
+   "Memory budget for transition tables in MB, sample on the fly above it. Default is unlimited");
+  if (MemBudget >= 0) { MemBudget *= 1024*1024; }
+  WalkFile = Env.GetIfArgPrefixStr("-wf:", "",
+   "Stream walks through this file instead of keeping them in memory");
   Verbose = Env.IsArgStr("-v", "Verbose output.");
   Directed = Env.IsArgStr("-dr", "Graph is directed.");
   Weighted = Env.IsArgStr("-w", "Graph is weighted.");
@@ -90,13 +96,16 @@ int main(int argc, char* argv[]) {
   int Dimensions, WalkLen, NumWalks, WinSize, Iter;
   double ParamP, ParamQ;
   bool Directed, Weighted, Verbose;
+  int64 MemBudget;
+  TStr WalkFile;
   ParseArgs(argc, argv, InFile, OutFile, Dimensions, WalkLen, NumWalks, WinSize,
-   Iter, Verbose, ParamP, ParamQ, Directed, Weighted);
+   Iter, Verbose, ParamP, ParamQ, Directed, Weighted, MemBudget,
+   WalkFile);
   PWNet InNet = PWNet::New();
   TIntFltVH EmbeddingsHV;
   ReadGraph(InFile, Directed, Weighted, Verbose, InNet);
   node2vec(InNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, EmbeddingsHV);
+   Verbose, EmbeddingsHV, MemBudget, WalkFile);
   WriteOutput(OutFile, EmbeddingsHV);
   return 0;
 }
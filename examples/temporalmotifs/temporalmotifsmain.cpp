@@ -6,6 +6,20 @@
 #include <omp.h>
 #endif
 
+// Writes the start of a reporting window followed by its motif counts
+static void WriteWindowCounts(FILE* output_file, int window_start,
+                              OnlineTempMotifCounter& otmc) {
+  Counter2D counts;
+  otmc.GetCounts(counts);
+  fprintf(output_file, "%d", window_start);
+  for (int i = 0; i < counts.m(); i++) {
+    for (int j = 0; j < counts.n(); j++) {
+      fprintf(output_file, " %s", counts(i, j).GetStr().CStr());
+    }
+  }
+  fprintf(output_file, "\n");
+}
+
 int main(int argc, char* argv[]) {
   Env = TEnv(argc, argv, TNotify::StdNotify);
   Env.PrepArgs(TStr::Fmt("Temporalmotifs. build: %s, %s. Time: %s",
@@ -23,23 +37,51 @@ int main(int argc, char* argv[]) {
     Env.GetIfArgPrefixFlt("-delta:", 4096, "Time window delta");
   const int num_threads =
     Env.GetIfArgPrefixInt("-nt:", 4, "Number of threads for parallelization");
+  const int window =
+    Env.GetIfArgPrefixInt("-w:", 0, "Length of reporting windows for online "
+                          "counting of time-ordered edges (0: count all at once)");
 
 #ifdef USE_OPENMP
   omp_set_num_threads(num_threads);
 #endif
 
-  // Count all 2-node and 3-node temporal motifs with 3 temporal edges
-  TempMotifCounter tmc(temporal_graph_filename);
-  Counter2D counts;
-  tmc.Count3TEdge23Node(delta, counts);
-  FILE* output_file = fopen(output.CStr(), "wt");
-  for (int i = 0; i < counts.m(); i++) {
-    for (int j = 0; j < counts.n(); j++) {
-      int count = counts(i, j);
-      fprintf(output_file, "%d", count);
-      if (j < counts.n() - 1) { fprintf(output_file, " "); }
+  if (window > 0) {
+    // Stream the edges through the online counter and write the counts of
+    // every non-empty reporting window on its own line
+    OnlineTempMotifCounter otmc(delta);
+    FILE* output_file = fopen(output.CStr(), "wt");
+    TSsParser Ss(temporal_graph_filename, ssfWhiteSep);
+    int window_start = 0;
+    bool has_edges = false;
+    while (Ss.Next()) {
+      int timestamp = Ss.GetInt(2);
+      if (has_edges && timestamp >= window_start + window) {
+        WriteWindowCounts(output_file, window_start, otmc);
+        otmc.ResetCounts();
+        has_edges = false;
+      }
+      if (!has_edges) {
+        window_start = timestamp - ((timestamp % window) + window) % window;
+        has_edges = true;
+      }
+      otmc.AddEdge(Ss.GetInt(0), Ss.GetInt(1), timestamp);
+    }
+    if (has_edges) { WriteWindowCounts(output_file, window_start, otmc); }
+    fclose(output_file);
+  } else {
+    // Count all 2-node and 3-node temporal motifs with 3 temporal edges
+    TempMotifCounter tmc(temporal_graph_filename);
+    Counter2D counts;
+    tmc.Count3TEdge23Node(delta, counts);
+    FILE* output_file = fopen(output.CStr(), "wt");
+    for (int i = 0; i < counts.m(); i++) {
+      for (int j = 0; j < counts.n(); j++) {
+        int count = counts(i, j);
+        fprintf(output_file, "%d", count);
+        if (j < counts.n() - 1) { fprintf(output_file, " "); }
+      }
+      fprintf(output_file, "\n");
     }
-    fprintf(output_file, "\n");
   }
   
   Catch
@@ -27,7 +27,16 @@ void TRnd::PutSeed(const int64& _Seed){
 }
 
 void TRnd::Move(const int64& Steps){
-  for (int64 StepN=0; StepN<Steps; StepN++){GetNextSeed();}
+  if (Seed<=0 || Seed>=m || Steps<64){
+    for (int64 StepN=0; StepN<Steps; StepN++){GetNextSeed();}
+  } else {
+    // Seed*a^Steps mod m by repeated squaring (operands are below 2^31)
+    int64 Pow=a, Exp=Steps;
+    while (Exp>0){
+      if (Exp&1){Seed=(Seed*Pow)%m;}
+      Pow=(Pow*Pow)%m; Exp>>=1;
+    }
+  }
 }
 
 bool TRnd::Check(){
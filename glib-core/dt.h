@@ -58,7 +58,7 @@ public:
   void PutSeed(const int64& _Seed);
   int64 GetSeed() const {return Seed;}
   void Randomize(){PutSeed(RndSeed);}
-  void Move(const int64& Steps);
+  void Move(const int64& Steps); // O(log Steps) for seeds in 1..m-1
   bool Check();
 
   static double GetUniDevStep(const int64& Seed, const int64& Steps){
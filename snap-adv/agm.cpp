@@ -103,8 +103,10 @@ void TAGMUtil::GenCmtyVVFromPL(TVec<TIntV>& CmtyVV, const PUNGraph& Graph, const
     CmtyVV.Clr();
     return;
   }
-  TIntV NIDV;
-  Graph->GetNIdV(NIDV);
+  TInt64V NIDV64;
+  Graph->GetNIdV(NIDV64);
+  TIntV NIDV(NIDV64.Len(), 0);
+  for (int i = 0; i < NIDV64.Len(); i++) { NIDV.Add((int) NIDV64[i]); }
   GenCmtyVVFromPL(CmtyVV, NIDV, Nodes, Coms, ComSzAlpha, MemAlpha, MinSz, MaxSz, MinK, MaxK, Rnd);
 }
 
@@ -147,7 +147,10 @@ void TAGMFast::SetGraph(const PUNGraph& GraphPt) {
   G = GraphPt;
   HOVIDSV.Gen(G->GetNodes());  
   NodesOk = true;
-  GraphPt->GetNIdV(NIDV);
+  TInt64V NIDV64;
+  GraphPt->GetNIdV(NIDV64);
+  NIDV.Gen(NIDV64.Len(), 0);
+  for (int u = 0; u < NIDV64.Len(); u++) { NIDV.Add((int) NIDV64[u]); }
   // check that nodes IDs are {0,1,..,Nodes-1}
   for (int nid = 0; nid < GraphPt->GetNodes(); nid++) {
     if (! GraphPt->IsNode(nid)) { 
@@ -419,7 +422,7 @@ int TAGMFast::MLENewton(const double& Thres, const int& MaxIter, const TStr& Plo
   TIntFltPrV IterLV;
   double PrevL = TFlt::Mn, CurL;
   TUNGraph::TNodeI UI;
-  TIntV NIdxV;
+  TInt64V NIdxV;
   G->GetNIdV(NIdxV);
   int CID, UID, NewtonIter;
   double Fuc;
@@ -567,7 +570,7 @@ int TAGMFast::FindComsByCV(TIntV& ComsV, const double HOFrac, const int NumThrea
   TVec<TVec<TIntSet> > HoldOutSets(MaxIterCV);
   if (EdgeV.Len() > 50) { //if edges are many enough, use CV
     printf("generating hold out set\n");
-    TIntV NIdV1, NIdV2;
+    TInt64V NIdV1, NIdV2;
     G->GetNIdV(NIdV1);
     G->GetNIdV(NIdV2);
     for (int IterCV = 0; IterCV < MaxIterCV; IterCV++) {
@@ -0,0 +1,534 @@
+#include "stdafx.h"
+#include "agmfastsp.h"
+#include "Snap.h"
+#include "agm.h"
+
+int TAGMFastSp::GetThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+int TAGMFastSp::GetThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+void TAGMFastSp::FreeRows() {
+  for (int t = 0; t < MovedRowVV.Len(); t++) {
+    for (int r = 0; r < MovedRowVV[t].Len(); r++) { free(MovedRowVV[t][r]); }
+    MovedRowVV[t].Clr();
+  }
+  free(PoolBf);
+  PoolBf = NULL;
+}
+
+void TAGMFastSp::SetGraph(const PUNGraph& GraphPt) {
+  G = GraphPt;
+  NodesOk = true;
+  TInt64V NIDV64;
+  GraphPt->GetNIdV(NIDV64);
+  NIDV.Gen(NIDV64.Len(), 0);
+  for (int u = 0; u < NIDV64.Len(); u++) { NIDV.Add((int) NIDV64[u]); }
+  // check that nodes IDs are {0,1,..,Nodes-1}
+  for (int nid = 0; nid < GraphPt->GetNodes(); nid++) {
+    if (! GraphPt->IsNode(nid)) {
+      NodesOk = false;
+      break;
+    }
+  }
+  if (! NodesOk) {
+    printf("rearrage nodes\n");
+    G = TSnap::GetSubGraph(GraphPt, NIDV, true);
+    for (int nid = 0; nid < G->GetNodes(); nid++) {
+      IAssert(G->IsNode(nid));
+    }
+  }
+  TSnap::DelSelfEdges(G);
+  // CSR adjacency
+  NbrOffV.Gen(G->GetNodes() + 1);
+  NbrV.Gen(2 * G->GetEdges(), 0);
+  for (int u = 0; u < G->GetNodes(); u++) {
+    TUNGraph::TNodeI NI = G->GetNI(u);
+    NbrOffV[u] = NbrV.Len();
+    for (int e = 0; e < NI.GetDeg(); e++) { NbrV.Add(NI.GetNbrNId(e)); }
+  }
+  NbrOffV[G->GetNodes()] = NbrV.Len();
+
+  PNoCom = 1.0 / (double) G->GetNodes();
+  if (1.0 / PNoCom > sqrt(TFlt::Mx)) { PNoCom = 0.99 / sqrt(TFlt::Mx); } // to prevent overflow
+  NegWgt = 1.0;
+}
+
+/// builds the row pool from per-node (community, value) lists, later values of a community win
+void TAGMFastSp::SetRows(TVec<TIntFltPrV>& RowFV) {
+  FreeRows();
+  RowV.Gen(RowFV.Len());
+  SumFV.Gen(NumComs);
+  MovedRowVV.Gen(GetThreads());
+  int64 PoolBytes = 0;
+  for (int u = 0; u < RowFV.Len(); u++) {
+    // stable sort keeps the insertion order of duplicates, keep the last one
+    TIntFltPrV& FV = RowFV[u];
+    for (int i = 1; i < FV.Len(); i++) {
+      TIntFltPr Pr = FV[i];
+      int j = i;
+      for (; j > 0 && FV[j-1].Val1 > Pr.Val1; j--) { FV[j] = FV[j-1]; }
+      FV[j] = Pr;
+    }
+    int Len = 0;
+    for (int i = 0; i < FV.Len(); i++) {
+      if (Len > 0 && FV[Len-1].Val1 == FV[i].Val1) { FV[Len-1] = FV[i]; }
+      else { FV[Len++] = FV[i]; }
+    }
+    FV.Trunc(Len);
+    PoolBytes += GetRowBytes(TMath::Mx(2 * Len, 4));
+  }
+  PoolBf = (char*) malloc(PoolBytes);
+  EAssertR(PoolBf != NULL, "Out of memory for community memberships");
+  char* Bf = PoolBf;
+  for (int u = 0; u < RowFV.Len(); u++) {
+    const TIntFltPrV& FV = RowFV[u];
+    TRowHd* Row = (TRowHd*) Bf;
+    Row->Len = FV.Len();
+    Row->Cap = TMath::Mx(2 * FV.Len(), 4);
+    int* CIDT = GetCIDT(Row);
+    double* ValT = GetValT(Row);
+    for (int i = 0; i < FV.Len(); i++) {
+      CIDT[i] = FV[i].Val1;
+      ValT[i] = FV[i].Val2;
+      SumFV[CIDT[i]] += ValT[i];
+    }
+    RowV[u] = Row;
+    Bf += GetRowBytes(Row->Cap);
+  }
+}
+
+/// moves all rows back into one contiguous pool in node order
+void TAGMFastSp::Compact() {
+  int64 PoolBytes = 0;
+  for (int u = 0; u < RowV.Len(); u++) {
+    PoolBytes += GetRowBytes(TMath::Mx(2 * RowV[u]->Len, 4));
+  }
+  char* NewPoolBf = (char*) malloc(PoolBytes);
+  EAssertR(NewPoolBf != NULL, "Out of memory for community memberships");
+  char* Bf = NewPoolBf;
+  for (int u = 0; u < RowV.Len(); u++) {
+    TRowHd* Row = RowV[u];
+    TRowHd* NewRow = (TRowHd*) Bf;
+    NewRow->Len = Row->Len;
+    NewRow->Cap = TMath::Mx(2 * Row->Len, 4);
+    memcpy(GetCIDT(NewRow), GetCIDT(Row), Row->Len * sizeof(int));
+    memcpy(GetValT(NewRow), GetValT(Row), Row->Len * sizeof(double));
+    RowV[u] = NewRow;
+    Bf += GetRowBytes(NewRow->Cap);
+  }
+  FreeRows();
+  PoolBf = NewPoolBf;
+}
+
+void TAGMFastSp::RandomInit(const int InitComs) {
+  NumComs = InitComs;
+  TVec<TIntFltPrV> RowFV(G->GetNodes());
+  TFltV ComSumV(InitComs);
+  for (int u = 0; u < RowFV.Len(); u++) {
+    //assign to just one community
+    int Mem = G->GetNI(u).GetDeg();
+    if (Mem > 10) { Mem = 10; }
+    for (int c = 0; c < Mem; c++) {
+      int CID = Rnd.GetUniDevInt(InitComs);
+      RowFV[u].Add(TIntFltPr(CID, Rnd.GetUniDev()));
+      ComSumV[CID] += RowFV[u].Last().Val2;
+    }
+  }
+  //assign a member to zero-member community (if any)
+  for (int c = 0; c < ComSumV.Len(); c++) {
+    if (ComSumV[c] == 0.0) {
+      int UID = Rnd.GetUniDevInt(G->GetNodes());
+      RowFV[UID].Add(TIntFltPr(c, Rnd.GetUniDev()));
+    }
+  }
+  SetRows(RowFV);
+}
+
+void TAGMFastSp::NeighborComInit(const int InitComs) {
+  //initialize with best neighborhood communities (Gleich et.al. KDD'12)
+  NumComs = InitComs;
+  TVec<TIntFltPrV> RowFV(G->GetNodes());
+  TBoolV ComUsedV(InitComs);
+  const int Edges = G->GetEdges();
+  TFltIntPrV NIdPhiV(G->GetNodes(), 0);
+  TIntSet InvalidNIDS(G->GetNodes());
+  TExeTm RunTm;
+  //compute conductance of neighborhood community
+  for (int u = 0; u < G->GetNodes(); u++) {
+    TIntSet NBCmty(G->GetNI(u).GetDeg() + 1);
+    double Phi;
+    if (G->GetNI(u).GetDeg() < 5) { //do not include nodes with too few degree
+      Phi = 1.0;
+    } else {
+      TAGMUtil::GetNbhCom(G, u, NBCmty);
+      Phi = TAGMUtil::GetConductance(G, NBCmty, Edges);
+    }
+    NIdPhiV.Add(TFltIntPr(Phi, u));
+  }
+  NIdPhiV.Sort(true);
+  printf("conductance computation completed [%s]\n", RunTm.GetTmStr());
+  fflush(stdout);
+  //choose nodes with local minimum in conductance
+  int CurCID = 0;
+  for (int ui = 0; ui < NIdPhiV.Len(); ui++) {
+    int UID = NIdPhiV[ui].Val2;
+    if (InvalidNIDS.IsKey(UID)) { continue; }
+    //add the node and its neighbors to the current community
+    RowFV[UID].Add(TIntFltPr(CurCID, 1.0));
+    TUNGraph::TNodeI NI = G->GetNI(UID);
+    for (int e = 0; e < NI.GetDeg(); e++) {
+      RowFV[NI.GetNbrNId(e)].Add(TIntFltPr(CurCID, 1.0));
+    }
+    ComUsedV[CurCID] = true;
+    //exclude its neighbors from the next considerations
+    for (int e = 0; e < NI.GetDeg(); e++) {
+      InvalidNIDS.AddKey(NI.GetNbrNId(e));
+    }
+    CurCID++;
+    if (CurCID >= NumComs) { break;  }
+  }
+  if (NumComs > CurCID) {
+    printf("%d communities needed to fill randomly\n", NumComs - CurCID);
+  }
+  //assign a member to zero-member community (if any)
+  for (int c = 0; c < ComUsedV.Len(); c++) {
+    if (! ComUsedV[c]) {
+      int ComSz = 10;
+      for (int u = 0; u < ComSz; u++) {
+        int UID = Rnd.GetUniDevInt(G->GetNodes());
+        RowFV[UID].Add(TIntFltPr(c, Rnd.GetUniDev()));
+      }
+    }
+  }
+  SetRows(RowFV);
+}
+
+void TAGMFastSp::SetCmtyVV(const TVec<TIntV>& CmtyVV) {
+  NumComs = CmtyVV.Len();
+  TVec<TIntFltPrV> RowFV(G->GetNodes());
+  TIntH NIDIdxH(NIDV.Len());
+  if (! NodesOk) {
+    for (int u = 0; u < NIDV.Len(); u++) {
+      NIDIdxH.AddDat(NIDV[u], u);
+    }
+  }
+  for (int c = 0; c < CmtyVV.Len(); c++) {
+    for (int u = 0; u < CmtyVV[c].Len(); u++) {
+      int UID = CmtyVV[c][u];
+      if (! NodesOk) { UID = NIDIdxH.GetDat(UID); }
+      if (G->IsNode(UID)) {
+        RowFV[UID].Add(TIntFltPr(c, 1.0));
+      }
+    }
+  }
+  SetRows(RowFV);
+}
+
+double TAGMFastSp::GetCom(const int& NID, const int& CID) const {
+  TRowHd* Row = RowV[NID];
+  const int* CIDT = GetCIDT(Row);
+  const int Pos = (int) (std::lower_bound(CIDT, CIDT + Row->Len, CID) - CIDT);
+  return Pos < Row->Len && CIDT[Pos] == CID ? GetValT(Row)[Pos] : 0.0;
+}
+
+void TAGMFastSp::InitWorkBf(TWorkBf& WorkBf) const {
+  WorkBf.FuV.Gen(NumComs);
+  WorkBf.GradV.Gen(NumComs);
+  WorkBf.NewFuV.Gen(NumComs);
+  WorkBf.MarkV.Gen(NumComs);
+  WorkBf.CandV.Gen(NumComs, 0);
+}
+
+double TAGMFastSp::LikelihoodForRow(const int UID, TWorkBf& WorkBf) {
+  TRowHd* RowU = RowV[UID];
+  const int LenU = RowU->Len;
+  const int* CIDU = GetCIDT(RowU);
+  const double* ValU = GetValT(RowU);
+  TFlt* FuT = WorkBf.FuV.BegI();
+  for (int i = 0; i < LenU; i++) { FuT[CIDU[i]] = ValU[i]; }
+  const double LogEps = log(1.0 / (1.0 - PNoCom));
+  double L = 0.0;
+  for (int e = NbrOffV[UID]; e < NbrOffV[UID+1]; e++) {
+    TRowHd* RowV2 = RowV[NbrV[e]];
+    const int* CIDT = GetCIDT(RowV2);
+    const double* ValT = GetValT(RowV2);
+    double DP = 0.0;
+    for (int j = 0; j < RowV2->Len; j++) { DP += FuT[CIDT[j]] * ValT[j]; }
+    L += log(1.0 - exp(-LogEps - DP)) + NegWgt * DP;
+  }
+  for (int i = 0; i < LenU; i++) {
+    L -= NegWgt * (SumFV[CIDU[i]] - ValU[i]) * ValU[i];
+    if (RegCoef > 0.0) { L -= RegCoef * ValU[i]; } //L1
+    if (RegCoef < 0.0) { L += RegCoef * ValU[i] * ValU[i]; } //L2
+  }
+  for (int i = 0; i < LenU; i++) { FuT[CIDU[i]] = 0.0; }
+  return L;
+}
+
+double TAGMFastSp::Likelihood() {
+  TVec<TWorkBf> WorkBfV(GetThreads());
+  for (int t = 0; t < WorkBfV.Len(); t++) { InitWorkBf(WorkBfV[t]); }
+  double L = 0.0;
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:L)
+  for (int u = 0; u < RowV.Len(); u++) {
+    L += LikelihoodForRow(u, WorkBfV[GetThreadN()]);
+  }
+  return L;
+}
+
+/// replaces the row of UID, in place if it fits into its slot. Concurrent readers see either values of the old or of the new row
+void TAGMFastSp::WriteRow(const int UID, const TIntV& CIDV, const TFltV& ValV) {
+  TRowHd* Row = RowV[UID];
+  if (CIDV.Len() > Row->Cap) {
+    const int Cap = 2 * CIDV.Len();
+    Row = (TRowHd*) malloc(GetRowBytes(Cap));
+    EAssertR(Row != NULL, "Out of memory for community memberships");
+    Row->Len = 0;
+    Row->Cap = Cap;
+    MovedRowVV[GetThreadN()].Add((char*) Row);
+  }
+  int* CIDT = GetCIDT(Row);
+  double* ValT = GetValT(Row);
+  const int Len = CIDV.Len();
+  if (Len < Row->Len) { Row->Len = Len; }
+  for (int i = 0; i < Len; i++) {
+    CIDT[i] = CIDV[i];
+    ValT[i] = ValV[i];
+  }
+  Row->Len = Len;
+  RowV[UID] = Row;
+}
+
+/// one projected gradient step with backtracking line search for the row of UID, returns false if the row did not change
+bool TAGMFastSp::UpdateRow(const int UID, const double& StepAlpha, const double& StepBeta, const int& MaxLineIter, TWorkBf& WorkBf, TIntV& NIDOPTV) {
+  TRowHd* RowU = RowV[UID];
+  const int LenU = RowU->Len;
+  const int* CIDU = GetCIDT(RowU);
+  const double* ValU = GetValT(RowU);
+  TFlt* FuT = WorkBf.FuV.BegI();
+  TFlt* GradT = WorkBf.GradV.BegI();
+  TFlt* NewFuT = WorkBf.NewFuV.BegI();
+  TIntV& CandV = WorkBf.CandV;
+  const int Beg = NbrOffV[UID], Deg = NbrOffV[UID+1] - NbrOffV[UID];
+  const double LogEps = log(1.0 / (1.0 - PNoCom));
+  WorkBf.DotV.Gen(Deg, Deg);
+  WorkBf.DotGradV.Gen(Deg, Deg);
+  TFlt* DotT = WorkBf.DotV.BegI();
+  TFlt* DotGradT = WorkBf.DotGradV.BegI();
+  // dot products with the neighbors and the likelihood of the current row
+  for (int i = 0; i < LenU; i++) { FuT[CIDU[i]] = ValU[i]; }
+  double InitL = 0.0;
+  for (int e = 0; e < Deg; e++) {
+    TRowHd* RowV2 = RowV[NbrV[Beg+e]];
+    const int* CIDT = GetCIDT(RowV2);
+    const double* ValT = GetValT(RowV2);
+    const int Len = RowV2->Len;
+    double DP = 0.0;
+    for (int j = 0; j < Len; j++) { DP += FuT[CIDT[j]] * ValT[j]; }
+    DotT[e] = DP;
+    const double Pred = exp(-LogEps - DP);
+    InitL += log(1.0 - Pred) + NegWgt * DP;
+    // gradient contribution of the neighbor, candidate communities are those of the neighbors
+    const double Wgt = Pred / (1.0 - Pred) + NegWgt;
+    for (int j = 0; j < Len; j++) {
+      const int CID = CIDT[j];
+      if (! WorkBf.MarkV[CID]) {
+        WorkBf.MarkV[CID] = true;
+        CandV.Add(CID);
+      }
+      GradT[CID] += Wgt * ValT[j];
+    }
+  }
+  for (int i = 0; i < LenU; i++) {
+    InitL -= NegWgt * (SumFV[CIDU[i]] - ValU[i]) * ValU[i];
+    if (RegCoef > 0.0) { InitL -= RegCoef * ValU[i]; }
+    if (RegCoef < 0.0) { InitL += RegCoef * ValU[i] * ValU[i]; }
+  }
+  CandV.Sort();
+  // projected gradient over the candidate communities
+  double GradNorm2 = 0.0;
+  for (int c = 0; c < CandV.Len(); c++) {
+    const int CID = CandV[c];
+    double Grad = GradT[CID] - NegWgt * (SumFV[CID] - FuT[CID]);
+    if (RegCoef > 0.0) { Grad -= RegCoef; }
+    if (RegCoef < 0.0) { Grad += 2 * RegCoef * FuT[CID]; }
+    if ((FuT[CID] == 0.0 && Grad < 0.0) || fabs(Grad) < 0.0001) { Grad = 0.0; }
+    if (Grad >= 10) { Grad = 10; }
+    if (Grad <= -10) { Grad = -10; }
+    GradT[CID] = Grad;
+    GradNorm2 += Grad * Grad;
+  }
+  bool Changed = false;
+  double StepSize = 0.0;
+  if (GradNorm2 < 1e-4) {
+    NIDOPTV[UID] = 1;
+  } else {
+    for (int e = 0; e < Deg; e++) {
+      TRowHd* RowV2 = RowV[NbrV[Beg+e]];
+      const int* CIDT = GetCIDT(RowV2);
+      const double* ValT = GetValT(RowV2);
+      double DP = 0.0;
+      for (int j = 0; j < RowV2->Len; j++) { DP += GradT[CIDT[j]] * ValT[j]; }
+      DotGradT[e] = DP;
+    }
+    // backtracking line search
+    StepSize = 1.0;
+    for (int Iter = 0; Iter < MaxLineIter; Iter++) {
+      double NewL = 0.0;
+      bool Clipped = false;
+      for (int c = 0; c < CandV.Len(); c++) {
+        const int CID = CandV[c];
+        double NewVal = FuT[CID] + StepSize * GradT[CID];
+        if (NewVal < MinVal) { NewVal = MinVal; Clipped = true; }
+        if (NewVal > MaxVal) { NewVal = MaxVal; Clipped = true; }
+        NewFuT[CID] = NewVal;
+        NewL -= NegWgt * (SumFV[CID] - FuT[CID]) * NewVal;
+        if (RegCoef > 0.0) { NewL -= RegCoef * NewVal; }
+        if (RegCoef < 0.0) { NewL += RegCoef * NewVal * NewVal; }
+      }
+      if (! Clipped) {
+        // dot products are linear in the step size
+        for (int e = 0; e < Deg; e++) {
+          const double DP = DotT[e] + StepSize * DotGradT[e];
+          NewL += log(1.0 - exp(-LogEps - DP)) + NegWgt * DP;
+        }
+      } else {
+        for (int e = 0; e < Deg; e++) {
+          TRowHd* RowV2 = RowV[NbrV[Beg+e]];
+          const int* CIDT = GetCIDT(RowV2);
+          const double* ValT = GetValT(RowV2);
+          double DP = 0.0;
+          for (int j = 0; j < RowV2->Len; j++) { DP += NewFuT[CIDT[j]] * ValT[j]; }
+          NewL += log(1.0 - exp(-LogEps - DP)) + NegWgt * DP;
+        }
+      }
+      if (NewL >= InitL + StepAlpha * StepSize * GradNorm2) { break; }
+      StepSize *= StepBeta;
+      if (Iter == MaxLineIter - 1) { StepSize = 0.0; }
+    }
+  }
+  // memberships not shared with any neighbor are dropped as in TAGMFast
+  if (StepSize > 0.0 || (CandV.Empty() && LenU > 0)) {
+    TIntV NewCIDV;
+    TFltV NewValV;
+    for (int c = 0; c < CandV.Len(); c++) {
+      const int CID = CandV[c];
+      double NewVal = TMath::Mx(MinVal.Val, TMath::Mn(MaxVal.Val, FuT[CID] + StepSize * GradT[CID]));
+      if (NewVal <= 0.0) { NewVal = 0.0; }
+      else {
+        NewCIDV.Add(CID);
+        NewValV.Add(NewVal);
+      }
+      if (NewVal != FuT[CID]) {
+#pragma omp atomic
+        SumFV[CID].Val += NewVal - FuT[CID];
+      }
+    }
+    for (int i = 0; i < LenU; i++) {
+      if (! WorkBf.MarkV[CIDU[i]]) {
+#pragma omp atomic
+        SumFV[CIDU[i]].Val -= ValU[i];
+      }
+    }
+    WriteRow(UID, NewCIDV, NewValV);
+    // the neighbors have to be optimized again
+    NIDOPTV[UID] = 0;
+    for (int e = 0; e < Deg; e++) { NIDOPTV[NbrV[Beg+e]] = 0; }
+    Changed = true;
+  }
+  // clear the work arrays
+  for (int i = 0; i < LenU; i++) { FuT[CIDU[i]] = 0.0; }
+  for (int c = 0; c < CandV.Len(); c++) {
+    const int CID = CandV[c];
+    FuT[CID] = 0.0;
+    GradT[CID] = 0.0;
+    NewFuT[CID] = 0.0;
+    WorkBf.MarkV[CID] = false;
+  }
+  CandV.Clr(false);
+  return Changed;
+}
+
+int TAGMFastSp::MLEGradAscent(const double& Thres, const int& MaxIter, const TStr& PlotNm, const double StepAlpha, const double StepBeta) {
+  const uint64 StartMSecs = TTm::GetCurUniMSecs();
+  TVec<TWorkBf> WorkBfV(GetThreads());
+  for (int t = 0; t < WorkBfV.Len(); t++) { InitWorkBf(WorkBfV[t]); }
+  if (MovedRowVV.Len() != WorkBfV.Len()) { MovedRowVV.Gen(WorkBfV.Len()); }
+  double PrevL = Likelihood();
+  TIntFltPrV IterLV;
+  TIntV NIdxV(RowV.Len(), 0);
+  TIntV NIDOPTV(RowV.Len()); //check if a node needs optimization or not 1: does not require optimization
+  int iter = 0;
+  for (iter = 0; iter < MaxIter; iter++) {
+    NIdxV.Clr(false);
+    for (int i = 0; i < RowV.Len(); i++) {
+      if (NIDOPTV[i] == 0) { NIdxV.Add(i); }
+    }
+    NIdxV.Shuffle(Rnd);
+    int64 Changed = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:Changed)
+    for (int ui = 0; ui < NIdxV.Len(); ui++) {
+      if (UpdateRow(NIdxV[ui], StepAlpha, StepBeta, 10, WorkBfV[GetThreadN()], NIDOPTV)) { Changed++; }
+    }
+    NodeUpdates += NIdxV.Len();
+    Compact();
+    const double CurL = Likelihood();
+    const double Secs = (TTm::GetCurUniMSecs() - StartMSecs) / 1000.0;
+    IterLV.Add(TIntFltPr(iter, CurL));
+    printf("\r%d iterations, Likelihood: %f, Diff: %f, %d nodes updated [%.1f secs]", iter, CurL,  CurL - PrevL, (int) Changed, Secs);
+    fflush(stdout);
+    if (CurL - PrevL <= Thres * fabs(PrevL)) { iter++; break; }
+    PrevL = CurL;
+  }
+  UpdateSecs += (TTm::GetCurUniMSecs() - StartMSecs) / 1000.0;
+  printf("\nMLE completed with %d iterations, %.0f node updates/sec\n", iter, GetUpdatesPerSec());
+  if (! PlotNm.Empty()) {
+    TGnuPlot::PlotValV(IterLV, PlotNm + ".likelihood_Q");
+  }
+  return iter;
+}
+
+void TAGMFastSp::GetCmtyVV(TVec<TIntV>& CmtyVV) {
+  GetCmtyVV(CmtyVV, sqrt(2.0 * (double) G->GetEdges() / G->GetNodes() / G->GetNodes()), 3);
+}
+
+/// extract community affiliation from F_uc
+void TAGMFastSp::GetCmtyVV(TVec<TIntV>& CmtyVV, const double Thres, const int MinSz) {
+  TVec<TFltIntPrV> ComNIdVV(NumComs);
+  for (int u = 0; u < RowV.Len(); u++) {
+    TRowHd* Row = RowV[u];
+    const int* CIDT = GetCIDT(Row);
+    const double* ValT = GetValT(Row);
+    for (int i = 0; i < Row->Len; i++) {
+      if (ValT[i] >= Thres) { ComNIdVV[CIDT[i]].Add(TFltIntPr(ValT[i], NodesOk ? u : NIDV[u].Val)); }
+    }
+  }
+  TFltIntPrV SumCIDV(NumComs, 0);
+  for (int c = 0; c < NumComs; c++) { SumCIDV.Add(TFltIntPr(SumFV[c], c)); }
+  SumCIDV.Sort(false);
+  CmtyVV.Gen(NumComs, 0);
+  for (int c = 0; c < NumComs; c++) {
+    const int CID = SumCIDV[c].Val2;
+    if (SumFV[CID] < Thres) { continue; }
+    TFltIntPrV& NIdV = ComNIdVV[CID];
+    NIdV.Sort(false);
+    TIntV CmtyV(NIdV.Len(), 0);
+    for (int i = 0; i < NIdV.Len(); i++) { CmtyV.Add(NIdV[i].Val2); }
+    if (CmtyV.Len() >= MinSz) { CmtyVV.Add(CmtyV); }
+  }
+  if ( NumComs != CmtyVV.Len()) {
+    printf("Community vector generated. %d communities are ommitted\n", NumComs.Val - CmtyVV.Len());
+  }
+}
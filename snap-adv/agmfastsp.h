@@ -0,0 +1,82 @@
+#ifndef snap_agmfastsp_h
+#define snap_agmfastsp_h
+#include "Snap.h"
+
+/////////////////////////////////////////////////
+/// Community detection with AGM (BigClam). Same model and line search as TAGMFast,
+/// but memberships F are stored as per-node sorted (community, value) rows in one
+/// contiguous pool, the adjacency is kept as CSR, and nodes are updated in parallel
+/// without locking (Hogwild). Rows that outgrow their slot in the pool are moved to
+/// a new slot and the pool is compacted after every pass over the nodes.
+class TAGMFastSp {
+private:
+  // header of a membership row, followed by Cap community ids and Cap values
+  struct TRowHd {
+    int Len, Cap;
+  };
+  // per-thread dense work arrays of length NumComs (all zero between updates)
+  struct TWorkBf {
+    TFltV FuV, GradV, NewFuV;
+    TBoolV MarkV;
+    TIntV CandV;
+    TFltV DotV, DotGradV;
+  };
+  PUNGraph G; //graph to fit
+  TIntV NIDV; // original node ID vector
+  TBool NodesOk; // Node ID is from 0 ~ N-1
+  TIntV NbrOffV, NbrV; // CSR adjacency of G without self edges
+  TVec<TRowHd*> RowV; // membership row of every node
+  char* PoolBf; // pool holding the rows after the last compaction
+  TVec<TVec<char*> > MovedRowVV; // rows moved out of the pool during the current pass, per thread
+  TFltV SumFV; // sum_u F_uc for each community c
+  TInt NumComs; // number of communities
+  TRnd Rnd; // random number generator
+  TFlt RegCoef; //Regularization coefficient when we fit for P_c +: L1, -: L2
+  TInt64 NodeUpdates; // number of row updates done by MLEGradAscent
+  TFlt UpdateSecs; // wall-clock time spent in MLEGradAscent
+  UndefCopyAssign(TAGMFastSp);
+private:
+  static int GetRowBytes(const int& Cap) { return sizeof(TRowHd) + (Cap * sizeof(int) + 7) / 8 * 8 + Cap * sizeof(double); }
+  static int* GetCIDT(TRowHd* Row) { return (int*) (Row + 1); }
+  static double* GetValT(TRowHd* Row) { return (double*) ((char*) (Row + 1) + (Row->Cap * sizeof(int) + 7) / 8 * 8); }
+  static int GetThreads();
+  static int GetThreadN();
+  void FreeRows();
+  void SetRows(TVec<TIntFltPrV>& RowFV);
+  void Compact();
+  void InitWorkBf(TWorkBf& WorkBf) const;
+  double LikelihoodForRow(const int UID, TWorkBf& WorkBf);
+  bool UpdateRow(const int UID, const double& StepAlpha, const double& StepBeta, const int& MaxLineIter, TWorkBf& WorkBf, TIntV& NIDOPTV);
+  void WriteRow(const int UID, const TIntV& CIDV, const TFltV& ValV);
+public:
+  TFlt MinVal; // minimum value of F (0)
+  TFlt MaxVal; // maximum value of F (for numerical reason)
+  TFlt NegWgt; // weight of negative example (a pair of nodes without an edge)
+  TFlt PNoCom; // base probability \varepsilon (edge probability between a pair of nodes sharing no community
+
+  TAGMFastSp(const PUNGraph& GraphPt, const int& InitComs, const int RndSeed = 0): PoolBf(NULL), Rnd(RndSeed), RegCoef(0),
+    NodeUpdates(0), UpdateSecs(0), MinVal(0.0), MaxVal(1000.0), NegWgt(1.0) { SetGraph(GraphPt); RandomInit(InitComs); }
+  ~TAGMFastSp() { FreeRows(); }
+  void SetGraph(const PUNGraph& GraphPt);
+  void SetRegCoef(const double _RegCoef) { RegCoef = _RegCoef; }
+  double GetRegCoef() { return RegCoef; }
+  void RandomInit(const int InitComs);
+  void NeighborComInit(const int InitComs);
+  void SetCmtyVV(const TVec<TIntV>& CmtyVV);
+  int GetNumComs() const { return NumComs; }
+  /// Returns F_uc, 0 if node NID does not belong to community CID. Uses node indices 0..N-1
+  double GetCom(const int& NID, const int& CID) const;
+  /// Returns the number of communities node NID belongs to
+  int GetComs(const int& NID) const { return RowV[NID]->Len; }
+  double Likelihood();
+  /// Runs parallel coordinate ascent passes over all non-optimal nodes until the likelihood improves by less than Thres (relative) or MaxIter passes are done. Returns the number of passes
+  int MLEGradAscent(const double& Thres, const int& MaxIter, const TStr& PlotNm = TStr(), const double StepAlpha = 0.3, const double StepBeta = 0.1);
+  /// Number of node updates done by MLEGradAscent
+  int64 GetNodeUpdates() const { return NodeUpdates; }
+  /// Node updates per second of MLEGradAscent
+  double GetUpdatesPerSec() const { return UpdateSecs > 0 ? NodeUpdates / UpdateSecs : 0.0; }
+  void GetCmtyVV(TVec<TIntV>& CmtyVV);
+  void GetCmtyVV(TVec<TIntV>& CmtyVV, const double Thres, const int MinSz = 3);
+};
+
+#endif
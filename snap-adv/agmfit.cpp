@@ -191,7 +191,7 @@ void TAGMFit::NeighborComInit(const int InitComs) {
   TIntV ChosenNIDV(InitComs, 0); //FOR DEBUG
   TExeTm RunTm;
   //compute conductance of neighborhood community
-  TIntV NIdV;
+  TInt64V NIdV;
   G->GetNIdV(NIdV);
   for (int u = 0; u < NIdV.Len(); u++) {
     TIntSet NBCmty(G->GetNI(NIdV[u]).GetDeg() + 1);
@@ -203,7 +203,7 @@ void TAGMFit::NeighborComInit(const int InitComs) {
       IAssert(NBCmty.Len() == G->GetNI(NIdV[u]).GetDeg() + 1);
       Phi = TAGMUtil::GetConductance(G, NBCmty, Edges);
     }
-    NIdPhiV.Add(TFltIntPr(Phi, NIdV[u]));
+    NIdPhiV.Add(TFltIntPr(Phi, (int) NIdV[u]));
   }
   NIdPhiV.Sort(true);
   printf("conductance computation completed [%s]\n", RunTm.GetTmStr());
@@ -253,7 +253,10 @@ void TAGMFit::AddBaseCmty() {
   GetCmtyVV(CmtyVV);
   TIntV TmpV = CmtyVV[0];
   CmtyVV.Add(TmpV);
-  G->GetNIdV(CmtyVV[0]);
+  TInt64V NIdV;
+  G->GetNIdV(NIdV);
+  CmtyVV[0].Gen(NIdV.Len(), 0);
+  for (int u = 0; u < NIdV.Len(); u++) { CmtyVV[0].Add((int) NIdV[u]); }
   IAssert(CIDNSetV.Len() + 1 == CmtyVV.Len());
   SetCmtyVV(CmtyVV);
   InitNodeData();
@@ -376,7 +379,7 @@ void TAGMFit::RunMCMC(const int& MaxIter, const int& EvalLambdaIter, const TStr&
   int SwitchCnt = 0, LeaveCnt = 0, JoinCnt = 0, AcceptCnt = 0, ProbBinSz;
   int Nodes = G->GetNodes(), Edges = G->GetEdges();
   TExeTm PlotTm;
-  ProbBinSz = TMath::Mx(1000, G->GetNodes() / 10); //bin to compute probabilities
+  ProbBinSz = TMath::Mx(1000, (int) (G->GetNodes() / 10)); //bin to compute probabilities
   IterLBV.Add(TIntFltPr(1, BestL));
 
   for (int iter = 0; iter < MaxIter; iter++) {
@@ -630,7 +633,7 @@ double TAGMFit::SelectLambdaSum(const TFltV& NewLambdaV, const TIntSet& ComK) {
 
 // Compute the empirical edge probability between a pair of nodes who share no community (epsilon), based on current community affiliations.
 double TAGMFit::CalcPNoComByCmtyVV(const int& SamplePairs) {
-  TIntV NIdV;
+  TInt64V NIdV;
   G->GetNIdV(NIdV);
   uint64 PairNoCom = 0, EdgesNoCom = 0;
   for (int u = 0; u < NIdV.Len(); u++) {
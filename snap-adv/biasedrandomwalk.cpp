@@ -37,7 +37,7 @@ void GetNodeAlias(TFltV& PTblV, TIntVFltVPr& NTTable) {
 }
 
 //Get random element using alias sampling method
-int64 AliasDrawInt(TIntVFltVPr& NTTable, TRnd& Rnd) {
+int64 AliasDrawInt(const TIntVFltVPr& NTTable, TRnd& Rnd) {
   int64 N = NTTable.GetVal1().Len();
   TInt X = static_cast<int64>(Rnd.GetUniDev()*N);
   double Y = Rnd.GetUniDev();
@@ -105,6 +105,79 @@ void PreprocessTransitionProbs(PWNet& InNet, double& ParamP, double& ParamQ, boo
   if(Verbose){ printf("\n"); }
 }
 
+//Preprocess second-order transition probabilities t->v->x for all predecessors t of node v
+void PreprocessCachedNode (PWNet& InNet, double& ParamP, double& ParamQ, TWNet::TNodeI CurrI) {
+  TFltV PTable(CurrI.GetOutDeg(), 0);
+  for (int64 i = 0; i < CurrI.GetInDeg(); i++) {
+    TWNet::TNodeI SrcI = InNet->GetNI(CurrI.GetInNId(i));          //for each node t
+    double Psum = 0;
+    PTable.Clr(false);
+    for (int64 j = 0; j < CurrI.GetOutDeg(); j++) {                 //for each node x
+      int64 FId = CurrI.GetNbrNId(j);
+      double Weight = CurrI.GetOutEDat(j);
+      if (FId == SrcI.GetId()) {
+        Weight /= ParamP;
+      } else if (!SrcI.IsOutNId(FId)) {
+        Weight /= ParamQ;
+      }
+      PTable.Add(Weight);
+      Psum += Weight;
+    }
+    for (int64 j = 0; j < PTable.Len(); j++) {
+      PTable[j] /= Psum;
+    }
+    GetNodeAlias(PTable, CurrI.GetDat().GetDat(SrcI.GetId()));
+  }
+}
+
+//Preprocess first-order transition probabilities v->x, stored under key -1, and
+//second-order tables for the highest degree nodes that fit into the memory budget
+void PreprocessFirstOrderProbs(PWNet& InNet, double& ParamP, double& ParamQ, const int64& MemBudget, bool& Verbose) {
+  const int64 EntryBytes = sizeof(TInt) + sizeof(TFlt);
+  int64 FreeBytes = MemBudget;
+  TIntPr64V DegNIdV;
+  for (TWNet::TNodeI NI = InNet->BegNI(); NI < InNet->EndNI(); NI++) {
+    InNet->SetNDat(NI.GetId(),TIntIntVFltVPrH());
+    NI.GetDat().AddDat(-1,TPair<TIntV,TFltV>(TIntV(NI.GetOutDeg()),TFltV(NI.GetOutDeg())));
+    FreeBytes -= NI.GetOutDeg()*EntryBytes;
+    DegNIdV.Add(TInt64Pr(NI.GetOutDeg(), NI.GetId()));
+  }
+  DegNIdV.Sort(false);
+  TIntV CachedNIds;
+  for (int64 i = 0; i < DegNIdV.Len() && FreeBytes > 0; i++) {       //allocating space in advance to avoid issues with multithreading
+    TWNet::TNodeI CurrI = InNet->GetNI(DegNIdV[i].Val2);
+    const int64 CacheBytes = CurrI.GetInDeg()*CurrI.GetOutDeg()*EntryBytes;
+    if (CurrI.GetOutDeg() == 0 || CacheBytes > FreeBytes) { continue; }
+    for (int64 j = 0; j < CurrI.GetInDeg(); j++) {
+      CurrI.GetDat().AddDat(CurrI.GetInNId(j),TPair<TIntV,TFltV>(TIntV(CurrI.GetOutDeg()),TFltV(CurrI.GetOutDeg())));
+    }
+    FreeBytes -= CacheBytes;
+    CachedNIds.Add(CurrI.GetId());
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (int64 i = 0; i < DegNIdV.Len(); i++) {
+    TWNet::TNodeI CurrI = InNet->GetNI(DegNIdV[i].Val2);
+    if (CurrI.GetOutDeg() == 0) { continue; }
+    TFltV PTable(CurrI.GetOutDeg());
+    double Psum = 0;
+    for (int64 j = 0; j < CurrI.GetOutDeg(); j++) {
+      Psum += CurrI.GetOutEDat(j);
+    }
+    for (int64 j = 0; j < CurrI.GetOutDeg(); j++) {
+      PTable[j] = CurrI.GetOutEDat(j) / Psum;
+    }
+    GetNodeAlias(PTable, CurrI.GetDat().GetDat(-1));
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (int64 i = 0; i < CachedNIds.Len(); i++) {
+    PreprocessCachedNode(InNet, ParamP, ParamQ, InNet->GetNI(CachedNIds[i]));
+  }
+  if (Verbose) {
+    printf("Cached second-order transition tables for %lld of %lld nodes\n",
+     (long long)CachedNIds.Len(), (long long)InNet->GetNodes());
+  }
+}
+
 int64 PredictMemoryRequirements(PWNet& InNet) {
   int64 MemNeeded = 0;
   for (TWNet::TNodeI NI = InNet->BegNI(); NI < InNet->EndNI(); NI++) {
@@ -130,3 +203,41 @@ void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, TRnd& Rnd, TIntV&
     WalkV.Add(InNet->GetNI(Dst).GetNbrNId(Next));
   }
 }
+
+//Simulates a random walk, second-order transitions of nodes without cached
+//tables are sampled from the first-order table and accepted with probability
+//proportional to the node2vec bias (KnightKing-style rejection sampling)
+void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, double& ParamP, double& ParamQ, TRnd& Rnd, TIntV& WalkV) {
+  WalkV.Add(StartNId);
+  if (WalkLen == 1) { return; }
+  if (InNet->GetNI(StartNId).GetOutDeg() == 0) { return; }
+  WalkV.Add(InNet->GetNI(StartNId).GetNbrNId(Rnd.GetUniDevInt(InNet->GetNI(StartNId).GetOutDeg())));
+  const double MxBias = TMath::Mx(1.0/ParamP, 1.0, 1.0/ParamQ);
+  while (WalkV.Len() < WalkLen) {
+    int64 Dst = WalkV.Last();
+    int64 Src = WalkV.LastLast();
+    TWNet::TNodeI DstI = InNet->GetNI(Dst);
+    if (DstI.GetOutDeg() == 0) { return; }
+    const TIntIntVFltVPrH& AliasH = DstI.GetDat();
+    const int64 KeyId = AliasH.GetKeyId(Src);
+    if (KeyId != -1) {
+      WalkV.Add(DstI.GetNbrNId(AliasDrawInt(AliasH[KeyId], Rnd)));
+      continue;
+    }
+    const TIntVFltVPr& FirstOrderTable = AliasH.GetDat(-1);
+    TWNet::TNodeI SrcI = InNet->GetNI(Src);
+    while (true) {
+      int64 Next = DstI.GetNbrNId(AliasDrawInt(FirstOrderTable, Rnd));
+      double Bias = 1.0;
+      if (Next == Src) {
+        Bias = 1.0/ParamP;
+      } else if (!SrcI.IsOutNId(Next)) {
+        Bias = 1.0/ParamQ;
+      }
+      if (Rnd.GetUniDev()*MxBias < Bias) {
+        WalkV.Add(Next);
+        break;
+      }
+    }
+  }
+}
@@ -4,12 +4,24 @@
 typedef TNodeEDatNet<TIntIntVFltVPrH, TFlt> TWNet;
 typedef TPt<TWNet> PWNet;
 
+///Builds the alias sampling table NTTable for the distribution PTblV. NTTable vectors must have the same length as PTblV
+void GetNodeAlias(TFltV& PTblV, TIntVFltVPr& NTTable);
+
+///Draws an index from the alias sampling table NTTable
+int64 AliasDrawInt(const TIntVFltVPr& NTTable, TRnd& Rnd);
+
 ///Preprocesses transition probabilities for random walks. Has to be called once before SimulateWalk calls
 void PreprocessTransitionProbs(PWNet& InNet, double& ParamP, double& ParamQ, bool& verbose);
 
+///Preprocesses first-order alias tables for sampling second-order transitions on the fly. Second-order tables are built only for the highest degree nodes that fit into MemBudget bytes together with the first-order tables
+void PreprocessFirstOrderProbs(PWNet& InNet, double& ParamP, double& ParamQ, const int64& MemBudget, bool& Verbose);
+
 ///Simulates one walk and writes it into Walk vector
 void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, TRnd& Rnd, TIntV& Walk);
 
+///Simulates one walk after PreprocessFirstOrderProbs, sampling uncached second-order transitions by rejection, and writes it into Walk vector
+void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, double& ParamP, double& ParamQ, TRnd& Rnd, TIntV& Walk);
+
 //Predicts approximate memory required for preprocessing the graph
 int64 PredictMemoryRequirements(PWNet& InNet);
 
@@ -259,6 +259,33 @@ double TKronMtx::GetApxNoEdgeDLL(const int& ParamId, int NId1, int NId2, const i
   return -ThetaCnt*exp(DLL) - ThetaCnt*exp(At(ThetaX, ThetaY)+2*DLL);
 }
 
+// GetEdgeDLL() and GetApxNoEdgeDLL() of parameter p count the cell (p % MtxDim, p / MtxDim) of each level
+void TKronMtx::AddApxEdgeDLL(int NId1, int NId2, const int& NKronIters, const double& Mul, TFltV& DLLV) const {
+  const int MxCells = 64;
+  if (Len() > MxCells) {
+    for (int p = 0; p < Len(); p++) {
+      DLLV[p] += Mul * (GetEdgeDLL(p, NId1, NId2, NKronIters) - GetApxNoEdgeDLL(p, NId1, NId2, NKronIters)); }
+    return;
+  }
+  int CellCntV[MxCells];
+  for (int c = 0; c < Len(); c++) { CellCntV[c] = 0; }
+  double LL = 0;
+  for (int level = 0; level < NKronIters; level++) {
+    const int Cell = MtxDim*(NId1 % MtxDim) + NId2 % MtxDim;
+    const double LVal = At(Cell); IAssert(LVal > NInf);
+    CellCntV[Cell]++;
+    LL += LVal;
+    NId1 /= MtxDim;  NId2 /= MtxDim;
+  }
+  for (int p = 0; p < Len(); p++) {
+    const int Cell = MtxDim*(p % MtxDim) + p / MtxDim;
+    const int ThetaCnt = CellCntV[Cell];
+    if (ThetaCnt == 0) { continue; }
+    const double DLL = LL - At(Cell); // all levels but one instance of the cell
+    DLLV[p] += Mul * (double(ThetaCnt) / exp(At(p)) + ThetaCnt*exp(DLL) + ThetaCnt*exp(At(Cell)+2*DLL));
+  }
+}
+
 uint TKronMtx::GetNodeSig(const double& OneProb) {
   uint Sig = 0;
   for (int i = 0; i < (int)(8*sizeof(uint)); i++) {
@@ -455,6 +482,172 @@ PNGraph TKronMtx::GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, co
   return Graph;
 }
 
+static int GetThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static int GetThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+// position of the first key >= Key in a sorted vector
+static int64 GetLowerBound(const TVec<TUInt64, int64>& KeyV, const uint64& Key) {
+  int64 Lo = 0, Hi = KeyV.Len();
+  while (Lo < Hi) {
+    const int64 Mid = Lo + (Hi - Lo) / 2;
+    if (KeyV[Mid].Val < Key) { Lo = Mid + 1; } else { Hi = Mid; }
+  }
+  return Lo;
+}
+
+// merges sorted runs of edge keys (Src << 32 | Dst) into a sorted KeyV without duplicates (runs are cleared);
+// the key space is cut into chunks at keys sampled from the runs and the chunks are merged in parallel
+static void MergeKeyRuns(TVec<TVec<TUInt64, int64> >& RunV, TVec<TUInt64, int64>& KeyV) {
+  const int Chunks = 4 * GetThreads();
+  TVec<TUInt64, int64> SampleV;
+  for (int r = 0; r < RunV.Len(); r++) {
+    const int64 Len = RunV[r].Len();
+    for (int64 s = 0; s < MIN(Len, (int64) 64 * Chunks); s++) {
+      SampleV.Add(RunV[r][Len * s / MIN(Len, (int64) 64 * Chunks)]); }
+  }
+  SampleV.Sort();
+  TVec<TVec<TUInt64, int64> > ChunkKeyVV(Chunks);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < Chunks; c++) {
+    const bool First = c == 0, Last = c == Chunks - 1;
+    const uint64 BegKey = First ? 0 : SampleV[SampleV.Len() * c / Chunks].Val;
+    const uint64 EndKey = Last ? 0 : SampleV[SampleV.Len() * (c + 1) / Chunks].Val;
+    TVec<TUInt64, int64>& ChunkKeyV = ChunkKeyVV[c];
+    for (int r = 0; r < RunV.Len(); r++) {
+      const int64 Beg = First ? 0 : GetLowerBound(RunV[r], BegKey);
+      const int64 End = Last ? RunV[r].Len() : GetLowerBound(RunV[r], EndKey);
+      for (int64 k = Beg; k < End; k++) { ChunkKeyV.Add(RunV[r][k]); }
+    }
+    ChunkKeyV.Merge(); // sort and remove duplicates
+  }
+  RunV.Clr();
+  TInt64V ChunkOffV(Chunks + 1);
+  ChunkOffV[0] = 0;
+  for (int c = 0; c < Chunks; c++) { ChunkOffV[c + 1] = ChunkOffV[c] + ChunkKeyVV[c].Len(); }
+  KeyV.Gen(ChunkOffV.Last());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < Chunks; c++) {
+    for (int64 k = 0; k < ChunkKeyVV[c].Len(); k++) { KeyV[ChunkOffV[c] + k] = ChunkKeyVV[c][k]; }
+    ChunkKeyVV[c].Clr();
+  }
+}
+
+// use RMat like recursive descent to generate a Kronecker graph in parallel; samples are drawn in rounds
+// until Edges distinct edges are found (as GenFastKronecker, an undirected edge counts twice)
+void TKronMtx::GenParFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& IsDir, const int& Seed, TVec<TIntPr, int64>& EdgeV) {
+  const TKronMtx& SeedGraph = SeedMtx;
+  const int MtxDim = SeedGraph.GetDim();
+  const double MtxSum = SeedGraph.GetMtxSum();
+  const int NNodes = SeedGraph.GetNodes(NIter);
+  const int64 NEdges = Edges >= 0 ? Edges : (int64) SeedGraph.GetEdges(NIter);
+  const int Threads = GetThreads();
+  printf("  ParFastKronecker: %d nodes, %s edges, %s, %d threads...\n", NNodes, TInt::GetStr(NEdges).CStr(), IsDir ? "Directed":"UnDirected", Threads);
+  const int64 BlockSz = 1<<16;
+  const int64 BaseSeed = Seed != 0 ? Seed : 1 + TRnd(0).GetUniDevInt(TInt::Mx - 1);
+  TExeTm ExeTm;
+  // prepare cell probability vector
+  TVec<TFltIntIntTr> ProbToRCPosV; // row, col position
+  double CumProb = 0.0;
+  for (int r = 0; r < MtxDim; r++) {
+    for (int c = 0; c < MtxDim; c++) {
+      const double Prob = SeedGraph.At(r, c);
+      if (Prob > 0.0) {
+        CumProb += Prob;
+        ProbToRCPosV.Add(TFltIntIntTr(CumProb/MtxSum, r, c));
+      }
+    }
+  }
+  // undirected edges are sampled as (min, max) pairs
+  const int64 NKeys = IsDir ? NEdges : (NEdges + 1) / 2;
+  TVec<TUInt64, int64> KeyV;
+  int64 Samples = 0;
+  while (KeyV.Len() < NKeys) {
+    const int64 Need = NKeys - KeyV.Len();
+    const int64 Blocks = (Need + BlockSz - 1) / BlockSz;
+    TVec<TVec<TUInt64, int64> > RunV(Threads + 1);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64 b = 0; b < Blocks; b++) {
+      TVec<TUInt64, int64>& ThreadKeyV = RunV[GetThreadN()];
+      TRnd Rnd(BaseSeed, (Samples + b * BlockSz) * NIter); // continue the stream of TRnd(Seed)
+      for (int64 e = b * BlockSz; e < MIN(Need, (b + 1) * BlockSz); e++) {
+        int Rng=NNodes, Row=0, Col=0, n=0;
+        for (int iter = 0; iter < NIter; iter++) {
+          const double& Prob = Rnd.GetUniDev();
+          n = 0; while(Prob > ProbToRCPosV[n].Val1) { n++; }
+          Rng /= MtxDim;
+          Row += ProbToRCPosV[n].Val2 * Rng;
+          Col += ProbToRCPosV[n].Val3 * Rng;
+        }
+        if (! IsDir && Row > Col) { ::Swap(Row, Col); }
+        ThreadKeyV.Add(((uint64) Row << 32) | (uint64) Col); // allow self-loops
+      }
+    }
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < Threads; t++) {
+      RunV[t].Merge(); }
+    RunV.Last().Swap(KeyV);
+    MergeKeyRuns(RunV, KeyV);
+    Samples += Need;
+  }
+  if (! IsDir) { // add the reverse of every edge that is not a self-loop
+    TVec<TVec<TUInt64, int64> > RunV(Threads + 1);
+    #pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < Threads; t++) {
+      TVec<TUInt64, int64>& RevKeyV = RunV[t];
+      for (int64 k = KeyV.Len() * t / Threads; k < KeyV.Len() * (t + 1) / Threads; k++) {
+        const uint64 Row = KeyV[k].Val >> 32, Col = KeyV[k].Val & 0xFFFFFFFF;
+        if (Row != Col) { RevKeyV.Add((Col << 32) | Row); }
+      }
+      RevKeyV.Sort();
+    }
+    RunV.Last().Swap(KeyV);
+    MergeKeyRuns(RunV, KeyV);
+  }
+  EdgeV.Gen(KeyV.Len());
+  #pragma omp parallel for schedule(static)
+  for (int64 k = 0; k < KeyV.Len(); k++) {
+    EdgeV[k] = TIntPr((int) (KeyV[k].Val >> 32), (int) (KeyV[k].Val & 0xFFFFFFFF)); }
+  printf("             %s edges, collisions: %s (%.4f) [%s]\n", TInt::GetStr(EdgeV.Len()).CStr(), TInt::GetStr(Samples-NKeys).CStr(),
+    (Samples-NKeys)/(double)NKeys, ExeTm.GetTmStr());
+}
+
+PNGraph TKronMtx::GenParFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& IsDir, const int& Seed) {
+  TVec<TIntPr, int64> EdgeV;
+  GenParFastKronecker(SeedMtx, NIter, Edges, IsDir, Seed, EdgeV);
+  const int NNodes = SeedMtx.GetNodes(NIter);
+  PNGraph Graph = TNGraph::New(NNodes, EdgeV.Len());
+  for (int i = 0; i < NNodes; i++) {
+    Graph->AddNode(i); }
+  // edges are sorted, so the in- and out-neighbor lists come out sorted
+  for (int64 e = 0; e < EdgeV.Len(); e++) {
+    Graph->AddEdgeUnchecked(EdgeV[e].Val1, EdgeV[e].Val2); }
+  return Graph;
+}
+
+void TKronMtx::SaveEdgeShards(const TVec<TIntPr, int64>& EdgeV, const TStr& FNmPref, const int& Shards) {
+  IAssert(Shards > 0);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int s = 0; s < Shards; s++) {
+    const int64 Beg = EdgeV.Len() * s / Shards, End = EdgeV.Len() * (s + 1) / Shards;
+    TFOut FOut(TStr::Fmt("%s.%d.bin", FNmPref.CStr(), s));
+    FOut.Save(End - Beg);  FOut.Save(End - Beg); // capacity and length
+    if (End > Beg) { FOut.PutBf(&EdgeV[Beg], (End - Beg) * sizeof(TIntPr)); }
+  }
+}
+
 PNGraph TKronMtx::GenDetKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir) {
   const TKronMtx& SeedGraph = SeedMtx;
   const int NNodes = SeedGraph.GetNodes(NIter);
@@ -780,15 +973,15 @@ TKronMtx TKronMtx::LoadTxt(const TStr& MtxFNm) {
 
 /////////////////////////////////////////////////
 // Kronecker Log Likelihood
-TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TFltV& ParamV, const double& PermPSwapNd): PermSwapNodeProb(PermPSwapNd) {
+TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TFltV& ParamV, const double& PermPSwapNd): PermSwapNodeProb(PermPSwapNd), Chains(1) {
   InitLL(GraphPt, TKronMtx(ParamV));
 }
 
-TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const double& PermPSwapNd) : PermSwapNodeProb(PermPSwapNd) {
+TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const double& PermPSwapNd) : PermSwapNodeProb(PermPSwapNd), Chains(1) {
   InitLL(GraphPt, ParamMtx);
 }
 
-TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const TIntV& NodeIdPermV, const double& PermPSwapNd) : PermSwapNodeProb(PermPSwapNd) {
+TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const TIntV& NodeIdPermV, const double& PermPSwapNd) : PermSwapNodeProb(PermPSwapNd), Chains(1) {
   InitLL(GraphPt, ParamMtx);
   NodePerm = NodeIdPermV;
   SetIPerm(NodePerm);
@@ -877,6 +1070,8 @@ void TKroneckerLL::SetIPerm(const TIntV& Perm) {
 	for (int i = 0; i < Perm.Len(); i++) {
 		InvertPerm[Perm[i]] = i;
 	}
+	// restart the other permutation chains from the new permutation
+	ChainPermV.Clr();  ChainIPermV.Clr();
 }
 
 void TKroneckerLL::SetGraph(const PNGraph& GraphPt) {
@@ -1035,38 +1230,54 @@ double TKroneckerLL::CalcGraphLL() {
 
 // approximate graph log-likelihood, takes O(E + N_0)
 double TKroneckerLL::CalcApxGraphLL() {
-  LogLike = GetApxEmptyGraphLL(); // O(N_0)
-  for (int nid = 0; nid < Nodes; nid++) {
-    const TNGraph::TNodeI Node = Graph->GetNI(nid);
-    const int SrcNId = NodePerm[nid];
-    for (int e = 0; e < Node.GetOutDeg(); e++) {
-      const int DstNId = NodePerm[Node.GetOutNId(e)];
-      LogLike = LogLike - LLMtx.GetApxNoEdgeLL(SrcNId, DstNId, KronIters)
-        + LLMtx.GetEdgeLL(SrcNId, DstNId, KronIters);
+  LogLike = GetApxGraphLL(NodePerm);
+  return LogLike;
+}
+
+// nodes are swept in parallel in fixed blocks whose sums are added in order,
+// so the result does not depend on the number of threads
+double TKroneckerLL::GetApxGraphLL(const TIntV& Perm) const {
+  const int BlockSz = 1024;
+  const int Blocks = (Nodes + BlockSz - 1) / BlockSz;
+  TFltV BlockLLV(Blocks);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int b = 0; b < Blocks; b++) {
+    double LL = 0.0;
+    for (int nid = b*BlockSz; nid < TMath::Mn((b+1)*BlockSz, Nodes()); nid++) {
+      const TNGraph::TNodeI Node = Graph->GetNI(nid);
+      const int SrcNId = Perm[nid];
+      for (int e = 0; e < Node.GetOutDeg(); e++) {
+        const int DstNId = Perm[Node.GetOutNId(e)];
+        LL = LL - LLMtx.GetApxNoEdgeLL(SrcNId, DstNId, KronIters)
+          + LLMtx.GetEdgeLL(SrcNId, DstNId, KronIters);
+      }
     }
+    BlockLLV[b] = LL;
   }
-  return LogLike;
+  double LL = GetApxEmptyGraphLL(); // O(N_0)
+  for (int b = 0; b < Blocks; b++) { LL += BlockLLV[b]; }
+  return LL;
 }
 
 // Used in TKroneckerLL::SwapNodesLL: DeltaLL if we
 // add the node to the matrix (node gets/creates all
 // of its in- and out-edges).
 // Zero is for the empty row/column (isolated node)
-double TKroneckerLL::NodeLLDelta(const int& NId) const {
+double TKroneckerLL::NodeLLDelta(const int& NId, const TIntV& Perm) const {
   if (! Graph->IsNode(NId)) { return 0.0; } // zero degree node
   double Delta = 0.0;
   const TNGraph::TNodeI Node = Graph->GetNI(NId);
   // out-edges
-  const int SrcRow = NodePerm[NId];
+  const int SrcRow = Perm[NId];
   for (int e = 0; e < Node.GetOutDeg(); e++) {
-    const int DstCol = NodePerm[Node.GetOutNId(e)];
+    const int DstCol = Perm[Node.GetOutNId(e)];
     Delta += - LLMtx.GetApxNoEdgeLL(SrcRow, DstCol, KronIters)
       + LLMtx.GetEdgeLL(SrcRow, DstCol, KronIters);
   }
   //in-edges
-  const int SrcCol = NodePerm[NId];
+  const int SrcCol = Perm[NId];
   for (int e = 0; e < Node.GetInDeg(); e++) {
-    const int DstRow = NodePerm[Node.GetInNId(e)];
+    const int DstRow = Perm[Node.GetInNId(e)];
     Delta += - LLMtx.GetApxNoEdgeLL(DstRow, SrcCol, KronIters)
       + LLMtx.GetEdgeLL(DstRow, SrcCol, KronIters);
   }
@@ -1080,55 +1291,55 @@ double TKroneckerLL::NodeLLDelta(const int& NId) const {
 }
 
 // swapping two nodes, only need to go over two rows and columns
-double TKroneckerLL::SwapNodesLL(const int& NId1, const int& NId2) {
+double TKroneckerLL::SwapNodesLL(const int& NId1, const int& NId2, TIntV& Perm, TIntV& IPerm, double LL) const {
   // subtract old LL (remove nodes)
-  LogLike = LogLike - NodeLLDelta(NId1) - NodeLLDelta(NId2);
-  const int PrevId1 = NodePerm[NId1], PrevId2 = NodePerm[NId2];
+  LL = LL - NodeLLDelta(NId1, Perm) - NodeLLDelta(NId2, Perm);
+  const int PrevId1 = Perm[NId1], PrevId2 = Perm[NId2];
   // double-counted edges
   if (Graph->IsEdge(NId1, NId2)) {
-    LogLike += - LLMtx.GetApxNoEdgeLL(PrevId1, PrevId2, KronIters)
+    LL += - LLMtx.GetApxNoEdgeLL(PrevId1, PrevId2, KronIters)
       + LLMtx.GetEdgeLL(PrevId1, PrevId2, KronIters); }
   if (Graph->IsEdge(NId2, NId1)) {
-    LogLike += - LLMtx.GetApxNoEdgeLL(PrevId2, PrevId1, KronIters)
+    LL += - LLMtx.GetApxNoEdgeLL(PrevId2, PrevId1, KronIters)
       + LLMtx.GetEdgeLL(PrevId2, PrevId1, KronIters); }
   // swap
-  NodePerm.Swap(NId1, NId2);
-  InvertPerm.Swap(NodePerm[NId1], NodePerm[NId2]);
+  Perm.Swap(NId1, NId2);
+  IPerm.Swap(Perm[NId1], Perm[NId2]);
   // add new LL (add nodes)
-  LogLike = LogLike + NodeLLDelta(NId1) + NodeLLDelta(NId2);
-  const int NewId1 = NodePerm[NId1], NewId2 = NodePerm[NId2];
+  LL = LL + NodeLLDelta(NId1, Perm) + NodeLLDelta(NId2, Perm);
+  const int NewId1 = Perm[NId1], NewId2 = Perm[NId2];
   // correct for double-counted edges
   if (Graph->IsEdge(NId1, NId2)) {
-    LogLike += + LLMtx.GetApxNoEdgeLL(NewId1, NewId2, KronIters)
+    LL += + LLMtx.GetApxNoEdgeLL(NewId1, NewId2, KronIters)
       - LLMtx.GetEdgeLL(NewId1, NewId2, KronIters); }
   if (Graph->IsEdge(NId2, NId1)) {
-    LogLike += + LLMtx.GetApxNoEdgeLL(NewId2, NewId1, KronIters)
+    LL += + LLMtx.GetApxNoEdgeLL(NewId2, NewId1, KronIters)
       - LLMtx.GetEdgeLL(NewId2, NewId1, KronIters); }
-  return LogLike;
+  return LL;
 }
 
 // metropolis sampling from P(permutation|graph)
-bool TKroneckerLL::SampleNextPerm(int& NId1, int& NId2) {
+bool TKroneckerLL::SampleNextPerm(int& NId1, int& NId2, TIntV& Perm, TIntV& IPerm, TFlt& LL, TRnd& Rnd) const {
   // pick 2 uniform nodes and swap
-  if (TKronMtx::Rnd.GetUniDev() < PermSwapNodeProb) {
-    NId1 = TKronMtx::Rnd.GetUniDevInt(Nodes);
-    NId2 = TKronMtx::Rnd.GetUniDevInt(Nodes);
-    while (NId2 == NId1) { NId2 = TKronMtx::Rnd.GetUniDevInt(Nodes); }
+  if (Rnd.GetUniDev() < PermSwapNodeProb) {
+    NId1 = Rnd.GetUniDevInt(Nodes);
+    NId2 = Rnd.GetUniDevInt(Nodes);
+    while (NId2 == NId1) { NId2 = Rnd.GetUniDevInt(Nodes); }
   } else {
     // pick uniform edge and swap endpoints (slow as it moves around high degree nodes)
-    const int e = TKronMtx::Rnd.GetUniDevInt(GEdgeV.Len());
+    const int e = Rnd.GetUniDevInt(GEdgeV.Len());
     NId1 = GEdgeV[e].Val1;  NId2 = GEdgeV[e].Val2;
   }
-  const double U = TKronMtx::Rnd.GetUniDev();
-  const double OldLL = LogLike;
-  const double NewLL = SwapNodesLL(NId1, NId2);
+  const double U = Rnd.GetUniDev();
+  const double OldLL = LL;
+  const double NewLL = SwapNodesLL(NId1, NId2, Perm, IPerm, LL);
   const double LogU = log(U);
   if (LogU > NewLL - OldLL) { // reject
-    LogLike = OldLL;
-    NodePerm.Swap(NId2, NId1); //swap back
-	InvertPerm.Swap(NodePerm[NId2], NodePerm[NId1]); // swap back
+    Perm.Swap(NId2, NId1); //swap back
+	IPerm.Swap(Perm[NId2], Perm[NId1]); // swap back
     return false;
   }
+  LL = NewLL;
   return true; // accept new sample
 }
 
@@ -1192,20 +1403,31 @@ const TFltV& TKroneckerLL::CalcFullApxGraphDLL() {
 
 // fast approximate gradient, runs O(E)
 const TFltV& TKroneckerLL::CalcApxGraphDLL() {
-  for (int ParamId = 0; ParamId < LLMtx.Len(); ParamId++) {
-    double DLL = GetApxEmptyGraphDLL(ParamId);
-    for (int nid = 0; nid < Nodes; nid++) {
+  GetApxGraphDLL(NodePerm, GradV);
+  return GradV;
+}
+
+// one parallel sweep over the edges for all parameters, blocks are added in order as in GetApxGraphLL()
+void TKroneckerLL::GetApxGraphDLL(const TIntV& Perm, TFltV& DLLV) const {
+  const int BlockSz = 1024;
+  const int Blocks = (Nodes + BlockSz - 1) / BlockSz;
+  TVec<TFltV> BlockDLLV(Blocks);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int b = 0; b < Blocks; b++) {
+    TFltV& DLL = BlockDLLV[b];
+    DLL.Gen(LLMtx.Len());
+    for (int nid = b*BlockSz; nid < TMath::Mn((b+1)*BlockSz, Nodes()); nid++) {
       const TNGraph::TNodeI Node = Graph->GetNI(nid);
-      const int SrcNId = NodePerm[nid];
+      const int SrcNId = Perm[nid];
       for (int e = 0; e < Node.GetOutDeg(); e++) {
-        const int DstNId = NodePerm[Node.GetOutNId(e)];
-        DLL = DLL - LLMtx.GetApxNoEdgeDLL(ParamId, SrcNId, DstNId, KronIters)
-          + LLMtx.GetEdgeDLL(ParamId, SrcNId, DstNId, KronIters);
-      }
+        LLMtx.AddApxEdgeDLL(SrcNId, Perm[Node.GetOutNId(e)], KronIters, 1.0, DLL); }
     }
-    GradV[ParamId] = DLL;
   }
-  return GradV;
+  DLLV.Gen(LLMtx.Len());
+  for (int ParamId = 0; ParamId < LLMtx.Len(); ParamId++) {
+    DLLV[ParamId] = GetApxEmptyGraphDLL(ParamId);
+    for (int b = 0; b < Blocks; b++) { DLLV[ParamId] += BlockDLLV[b][ParamId]; }
+  }
 }
 
 // Used in TKroneckerLL::UpdateGraphDLL: DeltaDLL if we
@@ -1236,64 +1458,111 @@ double TKroneckerLL::NodeDLLDelta(const int ParamId, const int& NId) const {
   return Delta;
 }
 
+// all parameters at once, see NodeDLLDelta()
+void TKroneckerLL::AddNodeDLLDelta(const int& NId, const TIntV& Perm, const double& Mul, TFltV& DLLV) const {
+  if (! Graph->IsNode(NId)) { return; } // zero degree node
+  const TNGraph::TNodeI Node = Graph->GetNI(NId);
+  const int SrcRow = Perm[NId];
+  for (int e = 0; e < Node.GetOutDeg(); e++) {
+    LLMtx.AddApxEdgeDLL(SrcRow, Perm[Node.GetOutNId(e)], KronIters, Mul, DLLV); }
+  const int SrcCol = Perm[NId];
+  for (int e = 0; e < Node.GetInDeg(); e++) {
+    LLMtx.AddApxEdgeDLL(Perm[Node.GetInNId(e)], SrcCol, KronIters, Mul, DLLV); }
+  // double counter self-edge
+  if (Graph->IsEdge(NId, NId)) {
+    LLMtx.AddApxEdgeDLL(SrcRow, SrcCol, KronIters, -Mul, DLLV); }
+}
+
 // given old DLL and new permutation, efficiently updates the DLL
 // permutation is new, but DLL is old
-void TKroneckerLL::UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2) {
-  for (int ParamId = 0; ParamId < LLMtx.Len(); ParamId++) {
-    // permutation before the swap (swap back to previous position)
-    NodePerm.Swap(SwapNId1, SwapNId2);
-    // subtract old DLL
-    TFlt& DLL = GradV[ParamId];
-    DLL = DLL - NodeDLLDelta(ParamId, SwapNId1) - NodeDLLDelta(ParamId, SwapNId2);
-    // double-counted edges
-    const int PrevId1 = NodePerm[SwapNId1], PrevId2 = NodePerm[SwapNId2];
-    if (Graph->IsEdge(SwapNId1, SwapNId2)) {
-      DLL += - LLMtx.GetApxNoEdgeDLL(ParamId, PrevId1, PrevId2, KronIters)
-        + LLMtx.GetEdgeDLL(ParamId, PrevId1, PrevId2, KronIters); }
-    if (Graph->IsEdge(SwapNId2, SwapNId1)) {
-      DLL += - LLMtx.GetApxNoEdgeDLL(ParamId, PrevId2, PrevId1, KronIters)
-        + LLMtx.GetEdgeDLL(ParamId, PrevId2, PrevId1, KronIters); }
-    // permutation after the swap (restore the swap)
-    NodePerm.Swap(SwapNId1, SwapNId2);
-    // add new DLL
-    DLL = DLL + NodeDLLDelta(ParamId, SwapNId1) + NodeDLLDelta(ParamId, SwapNId2);
-    const int NewId1 = NodePerm[SwapNId1], NewId2 = NodePerm[SwapNId2];
-    // double-counted edges
-    if (Graph->IsEdge(SwapNId1, SwapNId2)) {
-      DLL += + LLMtx.GetApxNoEdgeDLL(ParamId, NewId1, NewId2, KronIters)
-        - LLMtx.GetEdgeDLL(ParamId, NewId1, NewId2, KronIters); }
-    if (Graph->IsEdge(SwapNId2, SwapNId1)) {
-      DLL += + LLMtx.GetApxNoEdgeDLL(ParamId, NewId2, NewId1, KronIters)
-        - LLMtx.GetEdgeDLL(ParamId, NewId2, NewId1, KronIters); }
+void TKroneckerLL::UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2, TIntV& Perm, TFltV& DLLV) const {
+  // permutation before the swap (swap back to previous position)
+  Perm.Swap(SwapNId1, SwapNId2);
+  // subtract old DLL
+  AddNodeDLLDelta(SwapNId1, Perm, -1.0, DLLV);
+  AddNodeDLLDelta(SwapNId2, Perm, -1.0, DLLV);
+  // double-counted edges
+  const int PrevId1 = Perm[SwapNId1], PrevId2 = Perm[SwapNId2];
+  if (Graph->IsEdge(SwapNId1, SwapNId2)) {
+    LLMtx.AddApxEdgeDLL(PrevId1, PrevId2, KronIters, 1.0, DLLV); }
+  if (Graph->IsEdge(SwapNId2, SwapNId1)) {
+    LLMtx.AddApxEdgeDLL(PrevId2, PrevId1, KronIters, 1.0, DLLV); }
+  // permutation after the swap (restore the swap)
+  Perm.Swap(SwapNId1, SwapNId2);
+  // add new DLL
+  AddNodeDLLDelta(SwapNId1, Perm, 1.0, DLLV);
+  AddNodeDLLDelta(SwapNId2, Perm, 1.0, DLLV);
+  const int NewId1 = Perm[SwapNId1], NewId2 = Perm[SwapNId2];
+  // double-counted edges
+  if (Graph->IsEdge(SwapNId1, SwapNId2)) {
+    LLMtx.AddApxEdgeDLL(NewId1, NewId2, KronIters, -1.0, DLLV); }
+  if (Graph->IsEdge(SwapNId2, SwapNId1)) {
+    LLMtx.AddApxEdgeDLL(NewId2, NewId1, KronIters, -1.0, DLLV); }
+}
+
+// runs one permutation chain: WarmUp steps, then NSamples steps whose LL and DLL are added
+// to SumLL and SumDLLV, returns the number of accepted samples
+int TKroneckerLL::SampleChain(const int& WarmUp, const int& NSamples, TIntV& Perm, TIntV& IPerm, TFlt& LL, TFltV& DLLV,
+ TRnd& Rnd, double& SumLL, TFltV& SumDLLV) const {
+  int NId1=0, NId2=0, NAccept=0;
+  if (WarmUp > 0) {
+    LL = GetApxGraphLL(Perm);
+    for (int s = 0; s < WarmUp; s++) { SampleNextPerm(NId1, NId2, Perm, IPerm, LL, Rnd); }
+  }
+  LL = GetApxGraphLL(Perm); // re-calculate LL (due to numerical errors)
+  GetApxGraphDLL(Perm, DLLV);
+  SumLL = 0;
+  SumDLLV.Gen(LLMtx.Len());  SumDLLV.PutAll(0.0);
+  for (int s = 0; s < NSamples; s++) {
+    if (SampleNextPerm(NId1, NId2, Perm, IPerm, LL, Rnd)) { // new permutation
+      UpdateGraphDLL(NId1, NId2, Perm, DLLV);  NAccept++; }
+    for (int m = 0; m < LLMtx.Len(); m++) { SumDLLV[m] += DLLV[m]; }
+    SumLL += LL;
   }
+  return NAccept;
 }
 
+// chain 0 continues from NodePerm and uses TKronMtx::Rnd, chains 1..Chains-1 keep their own
+// permutations between calls and are seeded from TKronMtx::Rnd
 void TKroneckerLL::SampleGradient(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& AvgGradV) {
   printf("SampleGradient: %s (%s warm-up):", TInt::GetMegaStr(NSamples).CStr(), TInt::GetMegaStr(WarmUp).CStr());
-  int NId1=0, NId2=0, NAccept=0;
-  TExeTm ExeTm1;
-  if (WarmUp > 0) {
-    CalcApxGraphLL();
-    for (int s = 0; s < WarmUp; s++) { SampleNextPerm(NId1, NId2); }
-    printf("  warm-up:%s,", ExeTm1.GetTmStr());  ExeTm1.Tick();
+  const uint64 StartMSecs = TTm::GetCurUniMSecs();
+  if (ChainPermV.Len() != Chains-1) {
+    ChainPermV.Gen(Chains-1);  ChainIPermV.Gen(Chains-1);
+    for (int c = 0; c < Chains-1; c++) { ChainPermV[c] = NodePerm;  ChainIPermV[c] = InvertPerm; }
+  }
+  TVec<TRnd> RndV(Chains);
+  for (int c = 1; c < Chains; c++) { RndV[c].PutSeed(1 + TKronMtx::Rnd.GetUniDevInt(TInt::Mx - 1)); }
+  TFltV ChainLLV(Chains);
+  TVec<TFltV> ChainDLLV(Chains);
+  TFltV SumLLV(Chains);
+  TVec<TFltV> SumDLLV(Chains);
+  TIntV AcceptV(Chains);
+  const int ChainSamples = (NSamples + Chains - 1) / Chains;
+  #pragma omp parallel for schedule(dynamic, 1) if(Chains > 1)
+  for (int c = 0; c < Chains; c++) {
+    double SumLL = 0;
+    if (c == 0) {
+      AcceptV[c] = SampleChain(WarmUp, ChainSamples, NodePerm, InvertPerm, LogLike, GradV, TKronMtx::Rnd, SumLL, SumDLLV[c]);
+    } else {
+      AcceptV[c] = SampleChain(WarmUp, ChainSamples, ChainPermV[c-1], ChainIPermV[c-1], ChainLLV[c], ChainDLLV[c], RndV[c], SumLL, SumDLLV[c]);
+    }
+    SumLLV[c] = SumLL;
   }
-  CalcApxGraphLL(); // re-calculate LL (due to numerical errors)
-  CalcApxGraphDLL();
   AvgLL = 0;
   AvgGradV.Gen(LLMtx.Len());  AvgGradV.PutAll(0.0);
-  printf("  sampl");
-  for (int s = 0; s < NSamples; s++) {
-    if (SampleNextPerm(NId1, NId2)) { // new permutation
-      UpdateGraphDLL(NId1, NId2);  NAccept++; }
-    for (int m = 0; m < LLMtx.Len(); m++) { AvgGradV[m] += GradV[m]; }
-    AvgLL += GetLL();
-  }
-  printf("ing");
-  AvgLL = AvgLL / double(NSamples);
+  int NAccept = 0;
+  for (int c = 0; c < Chains; c++) {
+    AvgLL += SumLLV[c];
+    for (int m = 0; m < LLMtx.Len(); m++) { AvgGradV[m] += SumDLLV[c][m]; }
+    NAccept += AcceptV[c];
+  }
+  const double Samples = double(ChainSamples) * double(Chains);
+  AvgLL = AvgLL / Samples;
   for (int m = 0; m < LLMtx.Len(); m++) {
-    AvgGradV[m] = AvgGradV[m] / double(NSamples); }
-  printf(":%s (%.0f/s), accept %.1f%%\n", ExeTm1.GetTmStr(), double(NSamples)/ExeTm1.GetSecs(),
-    double(100*NAccept)/double(NSamples));
+    AvgGradV[m] = AvgGradV[m] / Samples; }
+  const double Secs = TMath::Mx(TTm::GetCurUniMSecs() - StartMSecs, (uint64) 1) / 1000.0;
+  printf("  %d chains:%.2fs (%.0f/s), accept %.1f%%\n", Chains(), Secs, Samples/Secs, 100.0*NAccept/Samples);
 }
 
 double TKroneckerLL::GradDescent(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples) {
@@ -1311,9 +1580,11 @@ double TKroneckerLL::GradDescent(const int& NIter, const double& LrnRate, double
 	  LLV.Gen(NIter, 0);
 	  MtxV.Gen(NIter, 0);
   }
+  StepTmV.Gen(NIter, 0);
 
   for (int Iter = 0; Iter < NIter; Iter++) {
     printf("%03d] ", Iter);
+    const uint64 IterMSecs = TTm::GetCurUniMSecs();
     SampleGradient(WarmUp, NSamples, CurLL, CurGradV);
     for (int p = 0; p < GetParams(); p++) {
       LearnRateV[p] *= 0.95;
@@ -1340,6 +1611,8 @@ double TKroneckerLL::GradDescent(const int& NIter, const double& LrnRate, double
     if (Iter+1 < NIter) { // skip last update
       ProbMtx = NewProbMtx;  ProbMtx.GetLLMtx(LLMtx); }
     OldLL=CurLL;
+    StepTmV.Add((TTm::GetCurUniMSecs() - IterMSecs) / 1000.0);
+    printf("  iter time: %.2fs\n", StepTmV.Last()());
     printf("\n");  fflush(stdout);
 
 	if(DebugMode) {  /// !!!!! MYUNGHWAN, CHECK!
@@ -1365,9 +1638,11 @@ double TKroneckerLL::GradDescent2(const int& NIter, const double& LrnRate, doubl
   LearnRateV.PutAll(LrnRate);
   TKronMtx NewProbMtx=ProbMtx, CurProbMtx=ProbMtx;
   bool GoodMove = false;
+  StepTmV.Gen(NIter, 0);
   // Start
   for (int Iter = 0; Iter < NIter; Iter++) {
     printf("%03d] ", Iter);
+    const uint64 IterMSecs = TTm::GetCurUniMSecs();
     if (! GoodMove) { SampleGradient(WarmUp, NSamples, CurLL, CurGradV); }
     CurProbMtx = ProbMtx;
     // update parameters
@@ -1405,6 +1680,8 @@ double TKroneckerLL::GradDescent2(const int& NIter, const double& LrnRate, doubl
       ProbMtx = CurProbMtx;  ProbMtx.GetLLMtx(LLMtx);
       GoodMove = false;
     }
+    StepTmV.Add((TTm::GetCurUniMSecs() - IterMSecs) / 1000.0);
+    printf("  iter time: %.2fs\n", StepTmV.Last()());
     printf("\n");  fflush(stdout);
   }
   printf("TotalExeTm: %s %g\n", TotalTm.GetStr(), TotalTm.GetSecs());
@@ -1707,8 +1984,10 @@ void TKroneckerLL::RunKronEM(const int& EMIter, const int& GradIter, double LrnR
 		LLV.Gen(EMIter, 0);
 		MtxV.Gen(EMIter, 0);
 	}
+	StepTmV.Gen(EMIter, 0);
 
 	for(int i = 0; i < EMIter; i++) {
+		const uint64 IterMSecs = TTm::GetCurUniMSecs();
 		printf("\n----------------------------------------------------------------------\n");
 		printf("%03d EM-iter] E-Step\n", i+1);
 		RunEStep(GibbsWarmUp, WarmUp, NSamples, LLV, DLLV);
@@ -1716,6 +1995,8 @@ void TKroneckerLL::RunKronEM(const int& EMIter, const int& GradIter, double LrnR
 
 		printf("%03d EM-iter] M-Step\n", i+1);
 		double CurLL = RunMStep(LLV, DLLV, GradIter, LrnRate, MnStep, MxStep);
+		StepTmV.Add((TTm::GetCurUniMSecs() - IterMSecs) / 1000.0);
+		printf("%03d EM-iter] time: %.2fs\n", i+1, StepTmV.Last()());
 		printf("\n\n");
 
 		if(DebugMode) {
@@ -73,6 +73,8 @@ public:
   double GetEdgeDLL(const int& ParamId, int NId1, int NId2, const int& NKronIters) const; // given LLMtx
   double GetNoEdgeDLL(const int& ParamId, int NId1, int NId2, const int& NKronIters) const; // given LLMtx
   double GetApxNoEdgeDLL(const int& ParamId, int NId1, int NId2, const int& NKronIters) const; // given LLMtx
+  // adds Mul*(GetEdgeDLL()-GetApxNoEdgeDLL()) of all parameters to DLLV in one pass over the levels
+  void AddApxEdgeDLL(int NId1, int NId2, const int& NKronIters, const double& Mul, TFltV& DLLV) const; // given LLMtx
 
   // edge prob from node signature
   static uint GetNodeSig(const double& OneProb = 0.5);
@@ -88,6 +90,13 @@ public:
   static PNGraph GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir, const int& Seed=0);
   static PNGraph GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int& Edges, const bool& IsDir, const int& Seed=0);
   static PNGraph GenDetKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir);
+  // parallel version of GenFastKronecker: edges are sampled in blocks that each draw their own range of the
+  // random stream of TRnd(Seed) (the result does not depend on the number of threads), EdgeV is sorted and has no duplicates
+  static void GenParFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& IsDir, const int& Seed, TVec<TIntPr, int64>& EdgeV);
+  static PNGraph GenParFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& IsDir, const int& Seed=0);
+  // saves EdgeV into Shards binary files FNmPref.<shard>.bin, each holding a contiguous range of EdgeV
+  // in the format of TVec<TIntPr, int64>::Save()
+  static void SaveEdgeShards(const TVec<TIntPr, int64>& EdgeV, const TStr& FNmPref, const int& Shards);
   static void PlotCmpGraphs(const TKronMtx& SeedMtx, const PNGraph& Graph, const TStr& OutFNm, const TStr& Desc);
   static void PlotCmpGraphs(const TKronMtx& SeedMtx1, const TKronMtx& SeedMtx2, const PNGraph& Graph, const TStr& OutFNm, const TStr& Desc);
   static void PlotCmpGraphs(const TVec<TKronMtx>& SeedMtxV, const PNGraph& Graph, const TStr& FNmPref, const TStr& Desc);
@@ -142,12 +151,28 @@ private:
   TFltV LLV;			// Log-likelihood (per EM iteration)
   TVec<TKronMtx> MtxV;	// Kronecker initiator matrix (per EM iteration)
 
+  TInt Chains;           // number of permutation chains sampled in parallel by SampleGradient()
+  TVec<TIntV> ChainPermV, ChainIPermV; // permutations of chains 1..Chains-1 (chain 0 is NodePerm)
+  TFltV StepTmV;         // run time in seconds (per gradient descent or EM iteration)
+
+private:
+  // permutation chain state is passed explicitly, so that several chains can share the graph
+  double GetApxGraphLL(const TIntV& Perm) const;
+  void GetApxGraphDLL(const TIntV& Perm, TFltV& DLLV) const;
+  double NodeLLDelta(const int& NId, const TIntV& Perm) const;
+  double SwapNodesLL(const int& NId1, const int& NId2, TIntV& Perm, TIntV& IPerm, double LL) const;
+  bool SampleNextPerm(int& NId1, int& NId2, TIntV& Perm, TIntV& IPerm, TFlt& LL, TRnd& Rnd) const;
+  void AddNodeDLLDelta(const int& NId, const TIntV& Perm, const double& Mul, TFltV& DLLV) const;
+  void UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2, TIntV& Perm, TFltV& DLLV) const;
+  int SampleChain(const int& WarmUp, const int& NSamples, TIntV& Perm, TIntV& IPerm, TFlt& LL, TFltV& DLLV,
+    TRnd& Rnd, double& SumLL, TFltV& SumDLLV) const;
+
 public:
   // RS 07/03/12, changed the order in the constructor initializer list
   //    so that it matches the declaration order. This changes also
   //    got rid of the compilation warnings. This is the old order:
   // TKroneckerLL() : Nodes(-1), KronIters(-1), PermSwapNodeProb(0.2), LogLike(TKronMtx::NInf), EMType(kronNodeMiss), RealNodes(-1), RealEdges(-1), MissEdges(-1), DebugMode(false) { }
-  TKroneckerLL() : Nodes(-1), KronIters(-1), PermSwapNodeProb(0.2), RealNodes(-1), RealEdges(-1), LogLike(TKronMtx::NInf), EMType(kronNodeMiss), MissEdges(-1), DebugMode(false) { }
+  TKroneckerLL() : Nodes(-1), KronIters(-1), PermSwapNodeProb(0.2), RealNodes(-1), RealEdges(-1), LogLike(TKronMtx::NInf), EMType(kronNodeMiss), MissEdges(-1), DebugMode(false), Chains(1) { }
   TKroneckerLL(const PNGraph& GraphPt, const TFltV& ParamV, const double& PermPSwapNd=0.2);
   TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const double& PermPSwapNd=0.2);
   TKroneckerLL(const PNGraph& GraphPt, const TKronMtx& ParamMtx, const TIntV& NodeIdPermV, const double& PermPSwapNd=0.2);
@@ -167,6 +192,11 @@ public:
   void SetDebug(const bool Debug) { DebugMode = Debug; }
   const TFltV& GetLLHist() const { return LLV; }
   const TVec<TKronMtx>& GetParamHist() const { return MtxV; }
+  // run time of the iterations of the last GradDescent(), GradDescent2() or RunKronEM()
+  const TFltV& GetStepTmHist() const { return StepTmV; }
+  // number of independent permutation chains that SampleGradient() runs in parallel and averages
+  void SetChains(const int& NChains) { IAssert(NChains > 0); Chains = NChains; }
+  int GetChains() const { return Chains; }
 
   // check actual nodes and edges (for KronEM)
   bool IsObsNode(const int& NId) const { IAssert(RealNodes > 0);	return (NId < RealNodes);	}
@@ -203,9 +233,9 @@ public:
   double CalcApxGraphLL();
   double GetLL() const { return LogLike; }
   double GetAbsErr() const { return fabs(pow((double)Graph->GetEdges(), 1.0/double(KronIters)) - ProbMtx.GetMtxSum()); }
-  double NodeLLDelta(const int& NId) const;
-  double SwapNodesLL(const int& NId1, const int& NId2);
-  bool SampleNextPerm(int& NId1, int& NId2); // sampling from P(perm|graph)
+  double NodeLLDelta(const int& NId) const { return NodeLLDelta(NId, NodePerm); }
+  double SwapNodesLL(const int& NId1, const int& NId2) { return LogLike = SwapNodesLL(NId1, NId2, NodePerm, InvertPerm, LogLike); }
+  bool SampleNextPerm(int& NId1, int& NId2) { return SampleNextPerm(NId1, NId2, NodePerm, InvertPerm, LogLike, TKronMtx::Rnd); } // sampling from P(perm|graph)
 
   // derivative of the log-likelihood
   double GetEmptyGraphDLL(const int& ParamId) const;
@@ -214,11 +244,11 @@ public:
   const TFltV& CalcFullApxGraphDLL();
   const TFltV& CalcApxGraphDLL();
   double NodeDLLDelta(const int ParamId, const int& NId) const;
-  void UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2);
+  void UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2) { UpdateGraphDLL(SwapNId1, SwapNId2, NodePerm, GradV); }
   const TFltV& GetDLL() const { return GradV; }
   double GetDLL(const int& ParamId) const { return GradV[ParamId]; }
 
-  // gradient
+  // gradient (averaged over GetChains() chains, each taking WarmUp and NSamples/GetChains() samples)
   void SampleGradient(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& GradV);
   double GradDescent(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples);
   double GradDescent2(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples);
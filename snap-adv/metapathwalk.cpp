@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "Snap.h"
+#include "metapathwalk.h"
+
+TMetapathWalk::TMetapathWalk(const PMMNet& MMNet, const TStr64V& Metapath, const TStr& EdgeWeightAttr) :
+  Net(MMNet), View(), StepCrossIdV(Metapath.Len(), 0), StepModeIdV(Metapath.Len(), 0), WeightAttr(EdgeWeightAttr), AliasHV(), StepAliasNV() {
+  IAssertR(Metapath.Len() > 0, "Metapath is empty.");
+  for (int64 i = 0; i < Metapath.Len(); i++) {
+    const int64 CrossId = Net->GetCrossId(Metapath[i]);
+    IAssertR(CrossId != -1, TStr::Fmt("CrossNet %s does not exist.", Metapath[i].CStr()));
+    StepCrossIdV.Add(CrossId);
+  }
+  // the start mode is the endpoint of the first crossnet from which the metapath returns to itself
+  const TCrossNet& FirstCross = Net->GetCrossNetById(StepCrossIdV[0]);
+  const int64 StartCandV[2] = { FirstCross.GetMode1(), FirstCross.GetMode2() };
+  for (int c = 0; c < 2 && StepModeIdV.Empty(); c++) {
+    int64 ModeId = StartCandV[c];
+    int64 s;
+    for (s = 0; s < StepCrossIdV.Len(); s++) {
+      const TCrossNet& Cross = Net->GetCrossNetById(StepCrossIdV[s]);
+      StepModeIdV.Add(ModeId);
+      if (ModeId == Cross.GetMode1()) { ModeId = Cross.GetMode2(); }
+      else if (ModeId == Cross.GetMode2()) { ModeId = Cross.GetMode1(); }
+      else { break; }
+    }
+    if (s < StepCrossIdV.Len() || ModeId != StartCandV[c]) { StepModeIdV.Clr(false); }
+  }
+  IAssertR(!StepModeIdV.Empty(), "Metapath does not start and end in the same mode.");
+  View = Net->GetSubgraphViewByCrossNet(Metapath);
+  if (WeightAttr.Empty()) { return; }
+  // alias tables are shared by the steps that leave the same mode over the same crossnet
+  THash<TInt64Pr, TInt64, int64> StepToAliasH;
+  for (int64 s = 0; s < StepCrossIdV.Len(); s++) {
+    const TInt64Pr Step(StepModeIdV[s], StepCrossIdV[s]);
+    if (!StepToAliasH.IsKey(Step)) {
+      StepToAliasH.AddDat(Step, AliasHV.Len());
+      PreprocessAlias(Step.Val1, Step.Val2, AliasHV[AliasHV.Add()]);
+    }
+    StepAliasNV.Add(StepToAliasH.GetDat(Step));
+  }
+}
+
+void TMetapathWalk::PreprocessAlias(const int64& ModeId, const int64& CrossId, THash<TInt64, TIntVFltVPr, int64>& AliasH) {
+  TCrossNet& Cross = Net->GetCrossNetById(CrossId);
+  TModeNet& Mode = Net->GetModeNetById(ModeId);
+  //allocating space in advance to avoid issues with multithreading
+  for (TNEANet::TNodeI NI = Mode.BegNI(); NI < Mode.EndNI(); NI++) {
+    const int64 NId = View->GetNId(ModeId, NI.GetId());
+    const int64 Deg = View->GetNI(NId).GetCrossNbrDeg(CrossId);
+    if (Deg > 0) { AliasH.AddDat(NId, TIntVFltVPr(TIntV(Deg), TFltV(Deg))); }
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (int64 KeyId = 0; KeyId < AliasH.GetMxKeyIds(); KeyId++) {
+    if (!AliasH.IsKeyId(KeyId)) { continue; }
+    const TMMNetView::TNodeI NI = View->GetNI(AliasH.GetKey(KeyId));
+    const int64 Deg = NI.GetCrossNbrDeg(CrossId);
+    TFltV PTable(Deg);
+    double Psum = 0;
+    for (int64 e = 0; e < Deg; e++) {
+      int64 EdgeCrossId, EId;
+      View->GetCrossEId(NI.GetCrossNbrEId(CrossId, e), EdgeCrossId, EId);
+      PTable[e] = Cross.GetFltAttrDatE(EId, WeightAttr);
+      Psum += PTable[e];
+    }
+    //Normalizing table
+    for (int64 e = 0; e < Deg; e++) {
+      PTable[e] = Psum > 0 ? PTable[e] / Psum : 1.0 / Deg;
+    }
+    GetNodeAlias(PTable, AliasH[KeyId]);
+  }
+}
+
+void TMetapathWalk::GetStartNIdV(TInt64V& NIdV) const {
+  const TModeNet& Mode = View->GetModeNetById(GetStartModeId());
+  NIdV.Gen(Mode.GetNodes(), 0);
+  for (TNEANet::TNodeI NI = Mode.BegNI(); NI < Mode.EndNI(); NI++) {
+    NIdV.Add(View->GetNId(GetStartModeId(), NI.GetId()));
+  }
+}
+
+void TMetapathWalk::SimulateWalk(const int64& StartNId, const int& WalkLen, TRnd& Rnd, TIntV& WalkV) const {
+  WalkV.Add(StartNId);
+  int64 Step = 0;
+  while (WalkV.Len() < WalkLen) {
+    const int64 CurNId = WalkV.Last();
+    const TMMNetView::TNodeI NI = View->GetNI(CurNId);
+    const int64 CrossId = StepCrossIdV[Step];
+    const int64 Deg = NI.GetCrossNbrDeg(CrossId);
+    if (Deg == 0) { return; }
+    const int64 EdgeN = WeightAttr.Empty() ? Rnd.GetUniDevInt(Deg) : AliasDrawInt(AliasHV[StepAliasNV[Step]].GetDat(CurNId), Rnd);
+    WalkV.Add(NI.GetCrossNbrNId(CrossId, EdgeN));
+    Step = (Step + 1) % StepCrossIdV.Len();
+  }
+}
+
+void TMetapathWalk::SimulateWalks(const int& WalkLen, const int& NumWalks, const bool& Verbose, TVVec<TInt, int64>& WalksVV, const int64& Seed) const {
+  TInt64V NIdsV;
+  GetStartNIdV(NIdsV);
+  int64 AllWalks = (int64)NumWalks * NIdsV.Len();
+  WalksVV = TVVec<TInt, int64>(AllWalks, WalkLen);
+  TRnd Rnd(Seed);
+  // every thread draws from its own generator, seeded from Rnd
+  int NThreads = 1;
+#ifdef USE_OPENMP
+  NThreads = omp_get_max_threads();
+#endif
+  TVec<TRnd> RndV(NThreads);
+  for (int t = 0; t < NThreads; t++) {
+    RndV[t].PutSeed(Rnd.GetUniDevInt(1, TInt::Mx-1));
+  }
+  int64 WalksDone = 0;
+  for (int64 i = 0; i < NumWalks; i++) {
+    NIdsV.Shuffle(Rnd);
+#pragma omp parallel for schedule(dynamic)
+    for (int64 j = 0; j < NIdsV.Len(); j++) {
+      if ( Verbose && WalksDone%10000 == 0 ) {
+        printf("\rWalking Progress: %.2lf%%",(double)WalksDone*100/(double)AllWalks);fflush(stdout);
+      }
+      int ThreadN = 0;
+#ifdef USE_OPENMP
+      ThreadN = omp_get_thread_num();
+#endif
+      TIntV WalkV;
+      SimulateWalk(NIdsV[j], WalkLen, RndV[ThreadN], WalkV);
+      for (int64 k = 0; k < WalkV.Len(); k++) {
+        WalksVV.PutXY(i*NIdsV.Len()+j, k, WalkV[k]);
+      }
+      WalksDone++;
+    }
+  }
+  if (Verbose) {
+    printf("\n");
+    fflush(stdout);
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef METAPATH_WALK_H
+#define METAPATH_WALK_H
+
+#include "biasedrandomwalk.h"
+
+//#//////////////////////////////////////////////
+/// Metapath-constrained random walks on a multimodal network. ##TMetapathWalk::Class
+/// The walker repeatedly follows the crossnets of the metapath in order, so the
+/// metapath has to start and end in the same mode (e.g. writes, writes for Author-Paper-Author).
+/// Walks are written as view-wide node ids of GetView(), so that nodes of different modes
+/// get distinct ids and can be fed to LearnEmbeddings directly.
+class TMetapathWalk {
+private:
+  PMMNet Net;
+  PMMNetView View;        // view over the metapath crossnets, no network data is copied
+  TInt64V StepCrossIdV;   // crossnet traversed at each step of the metapath
+  TInt64V StepModeIdV;    // mode of the walker before each step, StepModeIdV[0] is the start mode
+  TStr WeightAttr;        // float edge attribute with transition weights, uniform transitions if empty
+  TVec<THash<TInt64, TIntVFltVPr, int64>, int64> AliasHV; // per-node alias tables of each (mode, crossnet) pair
+  TInt64V StepAliasNV;    // index into AliasHV for each step
+private:
+  void PreprocessAlias(const int64& ModeId, const int64& CrossId, THash<TInt64, TIntVFltVPr, int64>& AliasH);
+public:
+  /// Prepares walks over crossnets Metapath of MMNet. If EdgeWeightAttr is given, transitions are proportional to that float crossnet attribute.
+  TMetapathWalk(const PMMNet& MMNet, const TStr64V& Metapath, const TStr& EdgeWeightAttr=TStr());
+
+  /// Returns the view whose node ids are used in the walks.
+  const PMMNetView& GetView() const { return View; }
+  /// Returns the id of the mode all the walks start in.
+  int64 GetStartModeId() const { return StepModeIdV[0]; }
+  /// Returns the view-wide ids of all the nodes in the start mode.
+  void GetStartNIdV(TInt64V& NIdV) const;
+
+  /// Simulates one walk from view-wide node StartNId and writes it into WalkV. The walk stops early if a node has no neighbors over the next crossnet.
+  void SimulateWalk(const int64& StartNId, const int& WalkLen, TRnd& Rnd, TIntV& WalkV) const;
+  /// Simulates NumWalks walks from every node of the start mode in parallel and writes them into WalksVV, one walk per row. ##TMetapathWalk::SimulateWalks
+  void SimulateWalks(const int& WalkLen, const int& NumWalks, const bool& Verbose, TVVec<TInt, int64>& WalksVV, const int64& Seed=0) const;
+};
+
+#endif //METAPATH_WALK_H
@@ -33,6 +33,175 @@ static void IncrementWeight(int i, int j, WeightVH& weights) {
   edge_weights(maxval) += 1;
 }
 
+static int GetNumThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static int GetThreadId() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+void WeightBuffer::Compact() {
+  if (pending_.Empty()) { return; }
+  pending_.Sort();
+  TVec< TPair<TUInt64, TInt> > merged(combined_.Len() + pending_.Len(), 0);
+  int i = 0;
+  int j = 0;
+  while (i < combined_.Len() || j < pending_.Len()) {
+    const TPair<TUInt64, TInt>& next =
+      (j == pending_.Len() ||
+       (i < combined_.Len() && combined_[i].Val1 <= pending_[j].Val1)) ?
+      combined_[i++] : pending_[j++];
+    if (!merged.Empty() && merged.Last().Val1 == next.Val1) {
+      merged.Last().Val2 += next.Val2;
+    } else {
+      merged.Add(next);
+    }
+  }
+  combined_.Swap(merged);
+  pending_.Clr();
+}
+
+// Position of the first entry of the sorted vector entries with key >= key
+static int LowerBound(const TVec< TPair<TUInt64, TInt> >& entries,
+                      uint64 key) {
+  int lo = 0;
+  int hi = entries.Len();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (entries[mid].Val1 < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+void WeightBuffer::Merge(TVec<WeightBuffer>& buffers, WeightVH& weights) {
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int b = 0; b < buffers.Len(); b++) {
+    buffers[b].Compact();
+  }
+  // Split the rows into chunks so that each row is written by one thread.  The
+  // entries of a chunk are sorted before they are added, so every row gets its
+  // columns in increasing order.
+  int num_rows = weights.Len();
+  int num_chunks = MIN(num_rows, 16 * GetNumThreads());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    uint64 row_beg = (int64) num_rows * chunk / num_chunks;
+    uint64 row_end = (int64) num_rows * (chunk + 1) / num_chunks;
+    TVec< TPair<TUInt64, TInt> > entries;
+    for (int b = 0; b < buffers.Len(); b++) {
+      const TVec< TPair<TUInt64, TInt> >& combined = buffers[b].combined_;
+      for (int i = LowerBound(combined, row_beg << 32);
+           i < combined.Len() && combined[i].Val1 < (row_end << 32); i++) {
+        entries.Add(combined[i]);
+      }
+    }
+    entries.Sort();
+    for (int i = 0; i < entries.Len(); i++) {
+      uint64 key = entries[i].Val1;
+      weights[(int) (key >> 32)]((int) (key & 0xFFFFFFFF)) += entries[i].Val2;
+    }
+  }
+  for (int b = 0; b < buffers.Len(); b++) {
+    buffers[b].combined_.Clr();
+  }
+}
+
+// Adjacency of the undirected graph underlying a directed graph, in compressed
+// form and indexed by node id.  The neighbors nbrs[offsets[u]..offsets[u+1])
+// of u are sorted by id and dirs holds the direction of each edge: 1 for
+// u --> nbr, 2 for nbr --> u and 3 for u <--> nbr.  Self loops are dropped.
+class UndirectedCSR {
+ public:
+  UndirectedCSR(PNGraph graph);
+
+  int Beg(int u) const { return offsets[u]; }
+  int End(int u) const { return offsets[u + 1]; }
+  // Position of v among the neighbors of u, -1 if the two are not adjacent
+  int Find(int u, int v) const;
+
+  TIntV offsets;
+  TIntV nbrs;
+  TIntV dirs;
+
+ private:
+  // Merges the sorted out- and in-neighbors of a node.  Writes them from
+  // position start on if write is set and returns the number of neighbors.
+  int MergeNbrs(const TNGraph::TNodeI& NI, bool write, int start);
+};
+
+UndirectedCSR::UndirectedCSR(PNGraph graph) {
+  TIntV node_ids;
+  node_ids.Reserve(graph->GetNodes());
+  for (TNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {
+    node_ids.Add(NI.GetId());
+  }
+  offsets = TIntV(graph->GetMxNId() + 2);
+  offsets.PutAll(0);
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int i = 0; i < node_ids.Len(); i++) {
+    offsets[node_ids[i] + 1] = MergeNbrs(graph->GetNI(node_ids[i]), false, 0);
+  }
+  for (int u = 1; u < offsets.Len(); u++) {
+    offsets[u] += offsets[u - 1];
+  }
+  nbrs = TIntV(offsets.Last());
+  dirs = TIntV(offsets.Last());
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int i = 0; i < node_ids.Len(); i++) {
+    MergeNbrs(graph->GetNI(node_ids[i]), true, offsets[node_ids[i]]);
+  }
+}
+
+int UndirectedCSR::MergeNbrs(const TNGraph::TNodeI& NI, bool write,
+                             int start) {
+  int src = NI.GetId();
+  int out_ind = 0;
+  int in_ind = 0;
+  int num_nbrs = 0;
+  while (out_ind < NI.GetOutDeg() || in_ind < NI.GetInDeg()) {
+    int out_nbr = out_ind < NI.GetOutDeg() ? NI.GetOutNId(out_ind) : TInt::Mx;
+    int in_nbr = in_ind < NI.GetInDeg() ? NI.GetInNId(in_ind) : TInt::Mx;
+    int nbr = MIN(out_nbr, in_nbr);
+    int dir = 0;
+    if (out_nbr == nbr) { dir |= 1; out_ind++; }
+    if (in_nbr == nbr)  { dir |= 2; in_ind++; }
+    if (nbr == src) { continue; }
+    if (write) {
+      nbrs[start + num_nbrs] = nbr;
+      dirs[start + num_nbrs] = dir;
+    }
+    num_nbrs++;
+  }
+  return num_nbrs;
+}
+
+int UndirectedCSR::Find(int u, int v) const {
+  int lo = offsets[u];
+  int hi = offsets[u + 1];
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (nbrs[mid] < v) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < offsets[u + 1] && nbrs[lo] == v) ? lo : -1;
+}
+
 MotifType MotifCluster::ParseMotifType(const TStr& motif) {
   TStr motif_lc = motif.GetLc();
   if      (motif_lc == "m1")          { return M1; }
@@ -180,6 +349,52 @@ bool MotifCluster::IsMotifM13(PNGraph graph, int center, int v, int w) {
 }
 
 
+
+// Checks (u, v, w) for a directed triangle motif or, with center u, for a
+// directed wedge motif.
+static bool IsMotifInstance(PNGraph graph, MotifType motif, int u, int v,
+                            int w) {
+  switch (motif) {
+  case M1:  return MotifCluster::IsMotifM1(graph, u, v, w);
+  case M2:  return MotifCluster::IsMotifM2(graph, u, v, w);
+  case M3:  return MotifCluster::IsMotifM3(graph, u, v, w);
+  case M4:  return MotifCluster::IsMotifM4(graph, u, v, w);
+  case M5:  return MotifCluster::IsMotifM5(graph, u, v, w);
+  case M6:  return MotifCluster::IsMotifM6(graph, u, v, w);
+  case M7:  return MotifCluster::IsMotifM7(graph, u, v, w);
+  case M8:  return MotifCluster::IsMotifM8(graph, u, v, w);
+  case M9:  return MotifCluster::IsMotifM9(graph, u, v, w);
+  case M10: return MotifCluster::IsMotifM10(graph, u, v, w);
+  case M11: return MotifCluster::IsMotifM11(graph, u, v, w);
+  case M12: return MotifCluster::IsMotifM12(graph, u, v, w);
+  case M13: return MotifCluster::IsMotifM13(graph, u, v, w);
+  default:
+    TExcept::Throw("Unknown directed triangle or wedge motif");
+  }
+  return false;
+}
+
+// Fills table so that table[d01 | (d12 << 2) | (d02 << 4)] tells whether
+// the nodes (0, 1, 2) form an instance of the motif, where dij is the
+// UndirectedCSR direction of the edge from i to j (0 for no edge).  The
+// table is obtained by running the motif check on every 3-node graph.
+static void MotifTable(MotifType motif, TBoolV& table) {
+  table = TBoolV(64);
+  int pairs[3][2] = {{0, 1}, {1, 2}, {0, 2}};
+  for (int code = 0; code < 64; code++) {
+    PNGraph graph = TNGraph::New();
+    for (int i = 0; i < 3; i++) {
+      graph->AddNode(i);
+    }
+    for (int p = 0; p < 3; p++) {
+      int dir = (code >> (2 * p)) & 3;
+      if (dir & 1) { graph->AddEdge(pairs[p][0], pairs[p][1]); }
+      if (dir & 2) { graph->AddEdge(pairs[p][1], pairs[p][0]); }
+    }
+    table[code] = IsMotifInstance(graph, motif, 0, 1, 2);
+  }
+}
+
 /////////////////////////////////////////////////
 // Triangle weighting
 void MotifCluster::DegreeOrdering(PNGraph graph, TIntV& order) {
@@ -212,198 +427,186 @@ void MotifCluster::DegreeOrdering(PNGraph graph, TIntV& order) {
 
 void MotifCluster::TriangleMotifAdjacency(PNGraph graph, MotifType motif,
                                           WeightVH& weights) {
+  TBoolV table;
+  MotifTable(motif, table);
   TIntV order;
   DegreeOrdering(graph, order);
-  for (TNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {
-    int src = NI.GetId();
-    int src_pos = order[src];
-    
-    // Get all neighbors who come later in the ordering
-    TIntV neighbors_higher;
-    for (int i = 0; i < NI.GetOutDeg(); i++) {
-      int nbr = NI.GetOutNId(i);
-      if (order[nbr] > src_pos) {
-        neighbors_higher.Add(nbr);
-      }
+  UndirectedCSR csr(graph);
+  int max_nodes = csr.offsets.Len() - 1;
+
+  // Keep the neighbors who come later in the ordering (still sorted by id)
+  TIntV higher_offsets(max_nodes + 1);
+  higher_offsets.PutAll(0);
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int src = 0; src < max_nodes; src++) {
+    int num_higher = 0;
+    for (int i = csr.Beg(src); i < csr.End(src); i++) {
+      if (order[csr.nbrs[i]] > order[src]) { num_higher++; }
     }
-    for (int i = 0; i < NI.GetInDeg(); i++) {
-      int nbr = NI.GetInNId(i);
-      if (!NI.IsOutNId(nbr) && order[nbr] > src_pos) {
-        neighbors_higher.Add(nbr);
+    higher_offsets[src + 1] = num_higher;
+  }
+  for (int src = 1; src <= max_nodes; src++) {
+    higher_offsets[src] += higher_offsets[src - 1];
+  }
+  TIntV higher(higher_offsets.Last());
+  TIntV higher_dirs(higher_offsets.Last());
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int src = 0; src < max_nodes; src++) {
+    int pos = higher_offsets[src];
+    for (int i = csr.Beg(src); i < csr.End(src); i++) {
+      if (order[csr.nbrs[i]] > order[src]) {
+        higher[pos] = csr.nbrs[i];
+        higher_dirs[pos] = csr.dirs[i];
+        pos++;
       }
     }
+  }
 
-    for (int ind1 = 0; ind1 < neighbors_higher.Len(); ind1++) {
-      for (int ind2 = ind1 + 1; ind2 < neighbors_higher.Len(); ind2++) {
-        int dst1 = neighbors_higher[ind1];
-        int dst2 = neighbors_higher[ind2];
-        // Check for triangle formation
-        if (graph->IsEdge(dst1, dst2) || graph->IsEdge(dst2, dst1)) {
-          bool motif_occurs = false;
-          switch (motif) {
-          case M1:
-            motif_occurs = IsMotifM1(graph, src, dst1, dst2);
-            break;
-          case M2:
-            motif_occurs = IsMotifM2(graph, src, dst1, dst2);
-            break;
-          case M3:
-            motif_occurs = IsMotifM3(graph, src, dst1, dst2);
-            break;
-          case M4:
-            motif_occurs = IsMotifM4(graph, src, dst1, dst2);
-            break;
-          case M5:
-            motif_occurs = IsMotifM5(graph, src, dst1, dst2);
-            break;
-          case M6:
-            motif_occurs = IsMotifM6(graph, src, dst1, dst2);
-            break;
-          case M7:
-            motif_occurs = IsMotifM7(graph, src, dst1, dst2);
-            break;
-          default:
-            TExcept::Throw("Unknown directed triangle motif");
-          }
+  // Every triangle is found once, from the node that comes first in the
+  // ordering, by intersecting its later neighbors with those of the second.
+  TVec<WeightBuffer> buffers(GetNumThreads());
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int src = 0; src < max_nodes; src++) {
+    WeightBuffer& buffer = buffers[GetThreadId()];
+    int src_end = higher_offsets[src + 1];
+    for (int ind1 = higher_offsets[src]; ind1 < src_end; ind1++) {
+      int dst1 = higher[ind1];
+      int ind2 = higher_offsets[src];
+      int ind3 = higher_offsets[dst1];
+      int dst1_end = higher_offsets[dst1 + 1];
+      while (ind2 < src_end && ind3 < dst1_end) {
+        if (higher[ind2] < higher[ind3]) {
+          ind2++;
+        } else if (higher[ind2] > higher[ind3]) {
+          ind3++;
+        } else {
+          int code = higher_dirs[ind1] | (higher_dirs[ind3] << 2) |
+            (higher_dirs[ind2] << 4);
           // Increment weights of the triad (src, dst1, dst2) if it occurs.
-          if (motif_occurs) {
-            IncrementWeight(src,  dst1, weights);
-            IncrementWeight(src,  dst2, weights);
-            IncrementWeight(dst1, dst2, weights);
+          if (table[code]) {
+            int dst2 = higher[ind2];
+            buffer.Add(src,  dst1);
+            buffer.Add(src,  dst2);
+            buffer.Add(dst1, dst2);
           }
+          ind2++;
+          ind3++;
         }
       }
     }
   }
+  WeightBuffer::Merge(buffers, weights);
 }
 
 /////////////////////////////////////////////////
 // Wedge weighting
 void MotifCluster::WedgeMotifAdjacency(PNGraph graph, MotifType motif,
                                        WeightVH& weights) {
-  for (TNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {
-    int center = NI.GetId();
-    
-    // Get all neighbors
-    TIntV neighbors;
-    for (int i = 0; i < NI.GetOutDeg(); i++) {
-      int nbr = NI.GetOutNId(i);
-      neighbors.Add(nbr);
-    }
-    for (int i = 0; i < NI.GetInDeg(); i++) {
-      int nbr = NI.GetInNId(i);
-      if (!NI.IsOutNId(nbr)) {
-        neighbors.Add(nbr);
-      }
-    }
-
-    for (int ind1 = 0; ind1 < neighbors.Len(); ind1++) {
-      for (int ind2 = ind1 + 1; ind2 < neighbors.Len(); ind2++) {
-        int dst1 = neighbors[ind1];
-        int dst2 = neighbors[ind2];
-        bool motif_occurs = false;
-        switch (motif) {
-        case M8:
-          motif_occurs = IsMotifM8(graph, center, dst1, dst2);
-          break;
-        case M9:
-          motif_occurs = IsMotifM9(graph, center, dst1, dst2);
-          break;
-        case M10:
-          motif_occurs = IsMotifM10(graph, center, dst1, dst2);
-          break;
-        case M11:
-          motif_occurs = IsMotifM11(graph, center, dst1, dst2);
-          break;
-        case M12:
-          motif_occurs = IsMotifM12(graph, center, dst1, dst2);
-          break;
-        case M13:
-          motif_occurs = IsMotifM13(graph, center, dst1, dst2);
-          break;
-        default:
-          TExcept::Throw("Unknown directed wedge motif");
-        }
+  TBoolV table;
+  MotifTable(motif, table);
+  UndirectedCSR csr(graph);
+  int max_nodes = csr.offsets.Len() - 1;
+
+  TVec<WeightBuffer> buffers(GetNumThreads());
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int center = 0; center < max_nodes; center++) {
+    WeightBuffer& buffer = buffers[GetThreadId()];
+    int beg = csr.Beg(center);
+    int end = csr.End(center);
+    // Number of wedges at center containing each neighbor
+    TIntV counts(end - beg);
+    counts.PutAll(0);
+    for (int ind1 = beg; ind1 < end; ind1++) {
+      int dst1 = csr.nbrs[ind1];
+      // Walk the neighbors of dst1 along the later neighbors of center to
+      // skip the pairs that are adjacent.
+      int nbr_ind = csr.Beg(dst1);
+      int nbr_end = csr.End(dst1);
+      for (int ind2 = ind1 + 1; ind2 < end; ind2++) {
+        int dst2 = csr.nbrs[ind2];
+        while (nbr_ind < nbr_end && csr.nbrs[nbr_ind] < dst2) { nbr_ind++; }
+        if (nbr_ind < nbr_end && csr.nbrs[nbr_ind] == dst2) { continue; }
         // Increment weights of (center, dst1, dst2) if it occurs.
-        if (motif_occurs) {
-          IncrementWeight(center, dst1, weights);
-          IncrementWeight(center, dst2, weights);
-          IncrementWeight(dst1,   dst2, weights);
+        if (table[csr.dirs[ind1] | (csr.dirs[ind2] << 4)]) {
+          counts[ind1 - beg]++;
+          counts[ind2 - beg]++;
+          buffer.Add(dst1, dst2);
         }
       }
     }
+    for (int ind = beg; ind < end; ind++) {
+      if (counts[ind - beg] > 0) {
+        buffer.Add(center, csr.nbrs[ind], counts[ind - beg]);
+      }
+    }
   }
+  WeightBuffer::Merge(buffers, weights);
 }
 
 
 /////////////////////////////////////////////////
 // Bifan weighting
 void MotifCluster::BifanMotifAdjacency(PNGraph graph, WeightVH& weights) {
-  // Find all pairs of nodes that are not adjacent
-  // Note: does not scale to large sparse networks but will work for smaller
-  // networks such as common neuronal connectivity datasets.
-  TIntV node_ids;
-  for (TNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {
-    node_ids.Add(NI.GetId());
-  }
-  for (int i = 0; i < node_ids.Len(); i++) {
-    for (int j = i + 1; j < node_ids.Len(); j++) {
-      int src1 = node_ids[i];
-      int src2 = node_ids[j];
-      if (IsNoEdge(graph, src1, src2)) {
-        // All unidirectional out-neighbors of src1
-        THash<TInt, TInt> nbr_counts;
-	TNGraph::TNodeI NI1 = graph->GetNI(src1);
-        for (int k = 0; k < NI1.GetOutDeg(); k++) {
-          int nbr = NI1.GetOutNId(k);
-          if (IsUnidirEdge(graph, src1, nbr)) {
-            nbr_counts(nbr) += 1;
-          }
-        }
-
-        // All unidirectional out-neighbors of src2
-	TNGraph::TNodeI NI2 = graph->GetNI(src2);
-        for (int k = 0; k < NI2.GetOutDeg(); k++) {
-          int nbr = NI2.GetOutNId(k);
-          if (IsUnidirEdge(graph, src2, nbr)) {
-            nbr_counts(nbr) += 1;
-          }
-        }
-
-        // Get all common outgoing neighbors
-        TIntV common;
-        for (THash<TInt, TInt>::TIter it = nbr_counts.BegI();
-	     it < nbr_counts.EndI(); it++) {
-          if (it->Dat == 2) {
-            common.Add(it->Key);
-          }
+  // Pairs of sources are found through their common unidirectional
+  // out-neighbors, so that only pairs two hops apart are considered.
+  UndirectedCSR csr(graph);
+  int max_nodes = csr.offsets.Len() - 1;
+
+  TVec<WeightBuffer> buffers(GetNumThreads());
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int src1 = 0; src1 < max_nodes; src1++) {
+    WeightBuffer& buffer = buffers[GetThreadId()];
+    // Common unidirectional out-neighbors of src1 and each later src2, in
+    // increasing order
+    THash<TInt, TIntV> common;
+    for (int i = csr.Beg(src1); i < csr.End(src1); i++) {
+      if (csr.dirs[i] != 1) { continue; }
+      int dst = csr.nbrs[i];
+      for (int j = csr.Beg(dst); j < csr.End(dst); j++) {
+        int src2 = csr.nbrs[j];
+        if (csr.dirs[j] == 2 && src2 > src1) {
+          common(src2).Add(dst);
         }
-
-        // Update weights with all common neighbors
-        for (int ind1 = 0; ind1 < common.Len(); ind1++) {
-          for (int ind2 = (ind1 + 1); ind2 < common.Len(); ind2++) {
-            int dst1 = common[ind1];
-            int dst2 = common[ind2];
-            if (IsNoEdge(graph, dst1, dst2)) {
-              IncrementWeight(src1, src2, weights);
-              IncrementWeight(src1, dst1, weights);
-              IncrementWeight(src1, dst2, weights);
-              IncrementWeight(src2, dst1, weights);
-              IncrementWeight(src2, dst2, weights);
-              IncrementWeight(dst1, dst2, weights);
-            }
+      }
+    }
+    for (THash<TInt, TIntV>::TIter it = common.BegI(); it < common.EndI();
+         it++) {
+      int src2 = it->Key;
+      const TIntV& dsts = it->Dat;
+      if (dsts.Len() < 2 || csr.Find(src1, src2) != -1) { continue; }
+      // Update weights with all pairs of common neighbors
+      for (int ind1 = 0; ind1 < dsts.Len(); ind1++) {
+        for (int ind2 = ind1 + 1; ind2 < dsts.Len(); ind2++) {
+          int dst1 = dsts[ind1];
+          int dst2 = dsts[ind2];
+          if (csr.Find(dst1, dst2) == -1) {
+            buffer.Add(src1, src2);
+            buffer.Add(src1, dst1);
+            buffer.Add(src1, dst2);
+            buffer.Add(src2, dst1);
+            buffer.Add(src2, dst2);
+            buffer.Add(dst1, dst2);
           }
         }
       }
     }
   }
+  WeightBuffer::Merge(buffers, weights);
 }
 
 
 /////////////////////////////////////////////////
 // Semiclique weighting
 void MotifCluster::SemicliqueMotifAdjacency(PUNGraph graph, WeightVH& weights) {
-  for (TUNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {  
+  TIntV node_ids;
+  for (TUNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI++) {
+    node_ids.Add(NI.GetId());
+  }
+  TVec<WeightBuffer> buffers(GetNumThreads());
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int i = 0; i < node_ids.Len(); i++) {
+    WeightBuffer& buffer = buffers[GetThreadId()];
+    TUNGraph::TNodeI NI = graph->GetNI(node_ids[i]);
     int src = NI.GetId();
     for (int j = 0; j < NI.GetDeg(); j++) {
       int dst = NI.GetNbrNId(j);
@@ -424,20 +627,20 @@ void MotifCluster::SemicliqueMotifAdjacency(PUNGraph graph, WeightVH& weights) {
           int nbr1 = common[k];
           int nbr2 = common[l];
           if (!graph->IsEdge(nbr1, nbr2)) {
-            IncrementWeight(src, dst, weights);
-            IncrementWeight(src, nbr1, weights);
-            IncrementWeight(src, nbr2, weights);            
-            IncrementWeight(dst, nbr1, weights);
-            IncrementWeight(dst, nbr2, weights);
-            IncrementWeight(nbr1, nbr2, weights);
+            buffer.Add(src, dst);
+            buffer.Add(src, nbr1);
+            buffer.Add(src, nbr2);            
+            buffer.Add(dst, nbr1);
+            buffer.Add(dst, nbr2);
+            buffer.Add(nbr1, nbr2);
           }
         }
       }
     }
   }
+  WeightBuffer::Merge(buffers, weights);
 }
 
-
 /////////////////////////////////////////////////
 // Simple edge weighting
 void MotifCluster::EdgeMotifAdjacency(PNGraph graph, WeightVH& weights) {
@@ -583,7 +786,76 @@ void ChibaNishizekiWeighter::Initialize(int k) {
 
 void ChibaNishizekiWeighter::Run(int k) {
   Initialize(k);
-  TIntV U(graph_[k].Len());
+  const TVec<TIntV>& graph_k = graph_[k];
+  int N = graph_k.Len();
+  TIntV U(N);
+  for (int i = 0; i < U.Len(); i++) {
+    U[i] = i;
+  }
+  TIntV order;
+  SubgraphDegreeOrder(k, U, order);
+  TIntV rank(N);
+  rank.PutAll(-1);
+  for (int i = 0; i < order.Len(); i++) {
+    rank[order[i]] = i;
+  }
+
+  TVec<WeightBuffer> buffers(GetNumThreads());
+  #pragma omp parallel
+  {
+    TIntV local_ids(N);
+    local_ids.PutAll(-1);
+    #pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < order.Len(); i++) {
+      int root = order[i];
+      TIntV nbrs;
+      for (int j = 0; j < graph_k[root].Len(); j++) {
+        int nbr = graph_k[root][j];
+        if (rank[nbr] > i) { nbrs.Add(nbr); }
+      }
+      if (nbrs.Len() < k - 1) { continue; }
+      for (int j = 0; j < nbrs.Len(); j++) {
+        local_ids[nbrs[j]] = j;
+      }
+      ChibaNishizekiWeighter local;
+      local.RunLocal(k - 1, root, nbrs, graph_k, local_ids,
+                     buffers[GetThreadId()]);
+      for (int j = 0; j < nbrs.Len(); j++) {
+        local_ids[nbrs[j]] = -1;
+      }
+    }
+  }
+  WeightBuffer::Merge(buffers, weights_);
+}
+
+void ChibaNishizekiWeighter::RunLocal(int k, int root, const TIntV& nbrs,
+                                      const TVec<TIntV>& graph_k,
+                                      const TIntV& local_ids,
+                                      WeightBuffer& buffer) {
+  k_ = k;
+  C_.Clr();
+  ids_ = nbrs;
+  root_ = root;
+  buffer_ = &buffer;
+  int N = nbrs.Len();
+  graph_ = TVec < TVec<TIntV> >(k + 2);
+  for (int i = 0; i < k + 2; ++i) {
+    graph_[i] = TVec<TIntV>(N);
+  }
+  labels_ = TIntV(N);
+  labels_.PutAll(k);
+
+  // Subgraph induced by nbrs
+  TVec<TIntV>& local_k = graph_[k];
+  for (int src = 0; src < N; src++) {
+    const TIntV& src_nbrs = graph_k[nbrs[src]];
+    for (int edge = 0; edge < src_nbrs.Len(); edge++) {
+      int dst = local_ids[src_nbrs[edge]];
+      if (dst != -1) { local_k[src].Add(dst); }
+    }
+  }
+
+  TIntV U(N);
   for (int i = 0; i < U.Len(); i++) {
     U[i] = i;
   }
@@ -615,8 +887,9 @@ void ChibaNishizekiWeighter::SubgraphDegreeOrder(int k, const TIntV& U,
 
 void ChibaNishizekiWeighter::UpdateWeights(const TIntV& clique) {
   for (int i = 0; i < clique.Len(); ++i) {
+    buffer_->Add(root_, ids_[clique[i]]);
     for (int j = i + 1; j < clique.Len(); ++j) {
-      IncrementWeight(clique[i], clique[j], weights_);
+      buffer_->Add(ids_[clique[i]], ids_[clique[j]]);
     }
   }
 }
@@ -826,23 +1099,17 @@ static void Sweep(const TSparseColMatrix& W, const TFltV& fvec, TFltV& conds,
     rank[order[i]] = i;
   }
 
-  // Sweep by adjusting cut and volume
-  conds = TFltV(order.Len() - 1);
-  double cut = 0;
-  double vol = 0;
-  double total_vol = 0;
-  for (int ind = 0; ind < order.Len(); ind++) {
-    const TIntFltKdV& nbr_weights = W.ColSpVV[ind];
-    for (TIntFltKdV::TIter it = nbr_weights.BegI(); it < nbr_weights.EndI();
-	 it++) {
-      total_vol += it->Dat;
-    }
-  }
-  double vol_comp = total_vol;
-  
-  for (int ind = 0; ind < order.Len() - 1; ind++) {
+  // Changes of the cut and of the volume when each node moves to the other side
+  // of the sweep, computed in parallel and then accumulated in order.
+  int num_sweeps = order.Len() - 1;
+  TFltV cut_deltas(MAX(num_sweeps, 0));
+  TFltV vol_deltas(MAX(num_sweeps, 0));
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int ind = 0; ind < num_sweeps; ind++) {
     int node = order[ind];
     const TIntFltKdV& nbr_weights = W.ColSpVV[node];
+    double cut_delta = 0;
+    double vol_delta = 0;
     for (TIntFltKdV::TIter it = nbr_weights.BegI(); it < nbr_weights.EndI();
 	 it++) {
       int nbr = it->Key;
@@ -851,15 +1118,36 @@ static void Sweep(const TSparseColMatrix& W, const TFltV& fvec, TFltV& conds,
       // Adjust the cut amount
       if (rank[nbr] > ind) {
         // nbr is on the other side: add to the cut
-        cut += val;
+        cut_delta += val;
       } else {
         // now on the same side as nbr: subtract from the cut
-        cut -= val;
+        cut_delta -= val;
       }
-      vol += val;
-      vol_comp -= val;
+      vol_delta += val;
+    }
+    cut_deltas[ind] = cut_delta;
+    vol_deltas[ind] = vol_delta;
+  }
+
+  double total_vol = 0;
+  #pragma omp parallel for reduction(+:total_vol)
+  for (int ind = 0; ind < order.Len(); ind++) {
+    const TIntFltKdV& nbr_weights = W.ColSpVV[ind];
+    for (TIntFltKdV::TIter it = nbr_weights.BegI(); it < nbr_weights.EndI();
+	 it++) {
+      total_vol += it->Dat;
     }
+  }
 
+  // Sweep by adjusting cut and volume
+  conds = TFltV(num_sweeps);
+  double cut = 0;
+  double vol = 0;
+  double vol_comp = total_vol;
+  for (int ind = 0; ind < num_sweeps; ind++) {
+    cut += cut_deltas[ind];
+    vol += vol_deltas[ind];
+    vol_comp -= vol_deltas[ind];
     double mvol = MIN(vol, vol_comp);
     if (mvol <= 0.0) {
       TExcept::Throw("Nonpositive set volume.");
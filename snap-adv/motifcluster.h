@@ -34,6 +34,34 @@ enum MotifType {
   edge,       // (undirected) edges
 };
 
+// Thread-local accumulator of motif adjacency weights.  Increments are buffered
+// as (min, max) node pairs packed into one key and are periodically sorted and
+// combined, so that threads never write to a shared WeightVH.  Merge() then adds
+// the weights of all buffers to a WeightVH in parallel over its rows.
+class WeightBuffer {
+ public:
+  WeightBuffer() {}
+
+  // Increments weight on (i, j) by count
+  void Add(int i, int j, int count=1) {
+    pending_.Add(TPair<TUInt64, TInt>(((uint64) MIN(i, j) << 32) |
+                                      (uint64) MAX(i, j), count));
+    if (pending_.Len() >= MAX(1 << 16, combined_.Len())) { Compact(); }
+  }
+
+  // Sorts the buffered increments and combines them into one weight per pair
+  void Compact();
+
+  // Adds the weights of all buffers to weights and clears the buffers.  For a
+  // given set of increments the result does not depend on how they were spread
+  // over the buffers.
+  static void Merge(TVec<WeightBuffer>& buffers, WeightVH& weights);
+
+ private:
+  TVec< TPair<TUInt64, TInt> > pending_;   // increments not yet combined
+  TVec< TPair<TUInt64, TInt> > combined_;  // sorted and unique pairs
+};
+
 // Container for sweep cut data.
 class TSweepCut {
  public:
@@ -148,13 +176,17 @@ class MotifCluster {
 };
 
 // Helper Class for doing undirected clique adjacency matrix weighting.  Uses
-// the Chiba & Nishizeki algorithm with (k-1)-core preprocessing.  See:
+// the Chiba & Nishizeki algorithm with (k-1)-core preprocessing.  The nodes of
+// the core are processed in parallel: the cliques whose first node in the
+// degree order is v are the (k-1)-cliques of the subgraph induced by the later
+// neighbors of v, which are enumerated by a local weighter.  See:
 //
 // Chiba, Norishige, and Takao Nishizeki. "Arboricity and subgraph listing
 // algorithms." SIAM Journal on Computing 14.1 (1985): 210-223.
 class ChibaNishizekiWeighter {
  public:
- ChibaNishizekiWeighter(PUNGraph graph) : orig_graph_(graph) {}
+ ChibaNishizekiWeighter(PUNGraph graph)
+   : orig_graph_(graph), root_(-1), buffer_(NULL) {}
   
   // Form motif adjacency matrix for cliques of size k
   void Run(int k);
@@ -163,6 +195,16 @@ class ChibaNishizekiWeighter {
   WeightVH& weights() { return weights_; }
   
  private:
+  // Local weighter used by Run()
+  ChibaNishizekiWeighter() : root_(-1), buffer_(NULL) {}
+
+  // Enumerate the (k-1)-cliques among the later neighbors nbrs of root in
+  // graph_k, where local_ids maps the nodes of nbrs to their positions (and
+  // all other nodes to -1), and add the k-cliques with root to buffer.
+  void RunLocal(int k, int root, const TIntV& nbrs,
+                const TVec<TIntV>& graph_k, const TIntV& local_ids,
+                WeightBuffer& buffer);
+
   // Get the order of nodes given by the subgraph induced by U
   void SubgraphDegreeOrder(int k, const TIntV& U, TIntV& order);
   
@@ -186,6 +228,9 @@ class ChibaNishizekiWeighter {
   int k_;  // size of clique
   PUNGraph orig_graph_;
   WeightVH weights_;  // motif adjacency weights
+  TIntV ids_;  // original id of each node of a local weighter
+  int root_;   // node added to every clique of a local weighter
+  WeightBuffer* buffer_;  // weights of a local weighter
 };
 
 #endif  // snap_motifcluster_h
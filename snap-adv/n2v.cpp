@@ -1,33 +1,89 @@
 #include "stdafx.h"
 #include "n2v.h"
 
+//Simulates a walk from each of StartNIdV[Beg..Beg+Walks) into rows Row..Row+Walks of WalksVV
+void SimulateWalks(PWNet& InNet, const TIntV& StartNIdV, const int64& Beg, const int64& Walks,
+ const bool& OnTheFly, double& ParamP, double& ParamQ, int& WalkLen, TRnd& Rnd, bool& Verbose,
+ const int64& AllWalks, int64& WalksDone, TVVec<TInt, int64>& WalksVV, const int64& Row) {
+#pragma omp parallel for schedule(dynamic)
+  for (int64 j = 0; j < Walks; j++) {
+    if ( Verbose && WalksDone%10000 == 0 ) {
+      printf("\rWalking Progress: %.2lf%%",(double)WalksDone*100/(double)AllWalks);fflush(stdout);
+    }
+    TIntV WalkV;
+    if (OnTheFly) {
+      SimulateWalk(InNet, StartNIdV[Beg+j], WalkLen, ParamP, ParamQ, Rnd, WalkV);
+    } else {
+      SimulateWalk(InNet, StartNIdV[Beg+j], WalkLen, Rnd, WalkV);
+    }
+    for (int64 k = 0; k < WalkV.Len(); k++) { 
+      WalksVV.PutXY(Row+j, k, WalkV[k]);
+    }
+    WalksDone++;
+  }
+}
+
 void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV) {
-  //Preprocess transition probabilities
-  PreprocessTransitionProbs(InNet, ParamP, ParamQ, Verbose);
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget, const TStr& WalkFNm) {
+  //Preprocess transition probabilities, sample them on the fly if they do not fit into memory
+  const bool OnTheFly = MemBudget >= 0 && PredictMemoryRequirements(InNet) > MemBudget;
+  if (OnTheFly) {
+    PreprocessFirstOrderProbs(InNet, ParamP, ParamQ, MemBudget, Verbose);
+  } else {
+    PreprocessTransitionProbs(InNet, ParamP, ParamQ, Verbose);
+  }
   TIntV NIdsV;
   for (TWNet::TNodeI NI = InNet->BegNI(); NI < InNet->EndNI(); NI++) {
     NIdsV.Add(NI.GetId());
   }
   //Generate random walks
   int64 AllWalks = (int64)NumWalks * NIdsV.Len();
-  TVVec<TInt, int64> WalksVV(AllWalks,WalkLen);
   TRnd Rnd(time(NULL));
   int64 WalksDone = 0;
-  for (int64 i = 0; i < NumWalks; i++) {
-    NIdsV.Shuffle(Rnd);
-#pragma omp parallel for schedule(dynamic)
-    for (int64 j = 0; j < NIdsV.Len(); j++) {
-      if ( Verbose && WalksDone%10000 == 0 ) {
-        printf("\rWalking Progress: %.2lf%%",(double)WalksDone*100/(double)AllWalks);fflush(stdout);
-      }
-      TIntV WalkV;
-      SimulateWalk(InNet, NIdsV[j], WalkLen, Rnd, WalkV);
-      for (int64 k = 0; k < WalkV.Len(); k++) { 
-        WalksVV.PutXY(i*NIdsV.Len()+j, k, WalkV[k]);
+  if (WalkFNm.Empty()) {
+    TVVec<TInt, int64> WalksVV(AllWalks,WalkLen);
+    for (int64 i = 0; i < NumWalks; i++) {
+      NIdsV.Shuffle(Rnd);
+      SimulateWalks(InNet, NIdsV, 0, NIdsV.Len(), OnTheFly, ParamP, ParamQ, WalkLen, Rnd,
+       Verbose, AllWalks, WalksDone, WalksVV, i*NIdsV.Len());
+    }
+    if (Verbose) {
+      printf("\n");
+      fflush(stdout);
+    }
+    //Learning embeddings
+    LearnEmbeddings(WalksVV, Dimensions, WinSize, Iter, Verbose, EmbeddingsHV);
+    return;
+  }
+  //Stream walks through WalkFNm in batches of node indices, so that memory stays bounded
+  const TIntV IdxNIdV = NIdsV;
+  TIntIntH NIdIdxH(NIdsV.Len());
+  for (int64 i = 0; i < IdxNIdV.Len(); i++) {
+    NIdIdxH.AddDat(IdxNIdV[i], i);
+  }
+  TIntV Vocab(IdxNIdV.Len());
+  {
+    TFOut FOut(WalkFNm);
+    FOut.Save(AllWalks);
+    FOut.Save(WalkLen);
+    TVVec<TInt, int64> WalksVV;
+    for (int64 i = 0; i < NumWalks; i++) {
+      NIdsV.Shuffle(Rnd);
+      for (int64 Beg = 0; Beg < NIdsV.Len(); Beg += WalkBatchN) {
+        const int64 Walks = TMath::Mn(WalkBatchN, NIdsV.Len() - Beg);
+        if (WalksVV.GetXDim() != Walks) { WalksVV.Gen(Walks, WalkLen); }
+        SimulateWalks(InNet, NIdsV, Beg, Walks, OnTheFly, ParamP, ParamQ, WalkLen, Rnd,
+         Verbose, AllWalks, WalksDone, WalksVV, 0);
+        for (int64 j = 0; j < WalksVV.GetXDim(); j++) {
+          for (int64 k = 0; k < WalkLen; k++) {
+            const int Idx = NIdIdxH.GetDat(WalksVV(j, k));
+            WalksVV(j, k) = Idx;
+            Vocab[Idx]++;
+          }
+        }
+        SaveWalkBatch(FOut, WalksVV);
       }
-      WalksDone++;
     }
   }
   if (Verbose) {
@@ -35,12 +91,13 @@ void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
     fflush(stdout);
   }
   //Learning embeddings
-  LearnEmbeddings(WalksVV, Dimensions, WinSize, Iter, Verbose, EmbeddingsHV);
+  LearnEmbeddings(WalkFNm, IdxNIdV, Vocab, WalkBatchN, Dimensions, WinSize, Iter,
+   Verbose, EmbeddingsHV);
 }
 
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV) {
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget, const TStr& WalkFNm) {
   PWNet NewNet = PWNet::New();
   for (TNGraph::TEdgeI EI = InNet->BegEI(); EI < InNet->EndEI(); EI++) {
     if (!NewNet->IsNode(EI.GetSrcNId())) { NewNet->AddNode(EI.GetSrcNId()); }
@@ -48,12 +105,12 @@ void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
     NewNet->AddEdge(EI.GetSrcNId(), EI.GetDstNId(), 1.0);
   }
   node2vec(NewNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, EmbeddingsHV);
+   Verbose, EmbeddingsHV, MemBudget, WalkFNm);
 }
 
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ,
  int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV) {
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget, const TStr& WalkFNm) {
   PWNet NewNet = PWNet::New();
   for (TNEANet::TEdgeI EI = InNet->BegEI(); EI < InNet->EndEI(); EI++) {
     if (!NewNet->IsNode(EI.GetSrcNId())) { NewNet->AddNode(EI.GetSrcNId()); }
@@ -61,5 +118,22 @@ void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ,
     NewNet->AddEdge(EI.GetSrcNId(), EI.GetDstNId(), InNet->GetFltAttrDatE(EI,"weight"));
   }
   node2vec(NewNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, EmbeddingsHV);
+   Verbose, EmbeddingsHV, MemBudget, WalkFNm);
+}
+
+void node2vec(const PMMNet& InNet, const TStr64V& Metapath, const TStr& WeightAttr,
+ int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
+ THash<TInt64Pr, TFltV, int64>& EmbeddingsHV) {
+  TMetapathWalk Walker(InNet, Metapath, WeightAttr);
+  //Generate random walks
+  TVVec<TInt, int64> WalksVV;
+  Walker.SimulateWalks(WalkLen, NumWalks, Verbose, WalksVV);
+  //Learning embeddings
+  TIntFltVH ViewEmbeddingsHV;
+  LearnEmbeddings(WalksVV, Dimensions, WinSize, Iter, Verbose, ViewEmbeddingsHV);
+  for (TIntFltVH::TIter It = ViewEmbeddingsHV.BegI(); It < ViewEmbeddingsHV.EndI(); It++) {
+    int64 ModeId, NId;
+    Walker.GetView()->GetModeNId(It.GetKey(), ModeId, NId);
+    EmbeddingsHV.AddDat(TInt64Pr(ModeId, NId), It.GetDat());
+  }
 }
@@ -5,20 +5,28 @@
 
 #include "Snap.h"
 #include "biasedrandomwalk.h"
+#include "metapathwalk.h"
 #include "word2vec.h"
 
 /// Calculates node2vec feature representation for nodes and writes them into EmbeddinsHV, see http://arxiv.org/pdf/1607.00653v1.pdf
+/// If MemBudget>=0 and the second-order transition tables need more than MemBudget bytes, transitions are sampled on the fly, see PreprocessFirstOrderProbs
+/// If WalkFNm is not empty, walks are written to WalkFNm in batches of WalkBatchN walks and read back in batches for training, instead of being kept in memory
 void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV); 
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget=-1, const TStr& WalkFNm=TStr()); 
 
 /// Version for unweighted graphs
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV); 
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget=-1, const TStr& WalkFNm=TStr()); 
 
 /// Version for weighted graphs. Edges must have TFlt attribute "weight"
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- TIntFltVH& EmbeddingsHV);
+ TIntFltVH& EmbeddingsHV, const int64& MemBudget=-1, const TStr& WalkFNm=TStr());
+
+/// Version for multimodal networks. Walks follow the crossnets in Metapath, see TMetapathWalk. Embeddings are keyed by (mode id, node id)
+void node2vec(const PMMNet& InNet, const TStr64V& Metapath, const TStr& WeightAttr,
+ int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
+ THash<TInt64Pr, TFltV, int64>& EmbeddingsHV);
 #endif //N2V_H
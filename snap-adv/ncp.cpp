@@ -237,6 +237,135 @@ void TLocClust::PlotNCP(const PUNGraph& Graph, const TStr& FNm, const TStr Desc,
   }
 }
 
+//////////////////////////////////////////////////
+// Local Spectral Clustering over dense node indices
+
+static int GetThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static int GetThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+TLocClustDense::TLocClustDense(const PUNGraph& Graph, const double& AlphaVal) :
+  Nodes((int) Graph->GetNodes()), Edges2(2*(int) Graph->GetEdges()), Alpha(AlphaVal) {
+  TIntV IdxV((int) Graph->GetMxNId());
+  NIdV.Gen(Nodes, 0);
+  for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    IdxV[(int) NI.GetId()] = NIdV.Len();
+    NIdV.Add((int) NI.GetId());
+  }
+  OffV.Gen(Nodes+1, 0);
+  NbrV.Gen(Edges2, 0);
+  OffV.Add(0);
+  for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    for (int e = 0; e < NI.GetOutDeg(); e++) {
+      NbrV.Add(IdxV[(int) NI.GetOutNId(e)]); }
+    OffV.Add(NbrV.Len());
+  }
+}
+
+// same pushes in the same order as TLocClust::ApproxPageRank()
+int TLocClustDense::ApproxPageRank(const int& SeedIdx, const double& Eps, TWork& Work) const {
+  TFltV& ProbV = Work.ProbV;
+  TFltV& ResV = Work.ResV;
+  TIntQ& NodeQ = Work.NodeQ;
+  if (ProbV.Len() != Nodes) {
+    ProbV.Gen(Nodes);  ResV.Gen(Nodes);
+    Work.RankV.Gen(Nodes);  Work.RankV.PutAll(-1);
+  }
+  ResV[SeedIdx] = 1.0;  Work.ResIdxV.Add(SeedIdx);
+  int iter = 0;
+  NodeQ.Clr(false);
+  NodeQ.Push(SeedIdx);
+  while (! NodeQ.Empty()) {
+    const int Idx = NodeQ.Top(); NodeQ.Pop();
+    const int IdxDeg = GetDeg(Idx);
+    const double PushVal = ResV[Idx] - 0.5*Eps*IdxDeg;
+    const double PutVal = (1.0-Alpha) * PushVal / double(IdxDeg);
+    if (Work.RankV[Idx] == -1) { Work.RankV[Idx] = 0;  Work.ProbIdxV.Add(Idx); }
+    ProbV[Idx] += Alpha*PushVal;
+    ResV[Idx] = 0.5 * Eps * IdxDeg;
+    for (int e = OffV[Idx]; e < OffV[Idx+1]; e++) {
+      const int DstIdx = NbrV[e];
+      const int DstDeg = GetDeg(DstIdx);
+      double& ResVal = ResV[DstIdx].Val;
+      if (ResVal == 0.0) { Work.ResIdxV.Add(DstIdx); }
+      const double OldRes = ResVal;
+      ResVal += PutVal;
+      if (ResVal >= Eps*DstDeg && OldRes < Eps*DstDeg) {
+        NodeQ.Push(DstIdx); }
+    }
+    iter++;
+    if (iter % Mega(1) == 0 && iter/1000 > Nodes) { break; } // too many iterations
+  }
+  return iter;
+}
+
+// the sweep order is by decreasing PageRank/degree, ties in the order the nodes got their PageRank
+void TLocClustDense::SupportSweep(TWork& Work, TSweep& Sweep) const {
+  TIntV& RankV = Work.RankV;
+  TFltIntPrV& SortV = Work.SortV;
+  SortV.Gen(Work.ProbIdxV.Len(), 0);
+  for (int i = 0; i < Work.ProbIdxV.Len(); i++) {
+    const int Idx = Work.ProbIdxV[i];
+    SortV.Add(TFltIntPr(-Work.ProbV[Idx] / double(GetDeg(Idx)), i)); }
+  SortV.Sort();
+  Sweep.NIdV.Gen(SortV.Len(), 0);
+  Sweep.VolV.Gen(SortV.Len(), 0);  Sweep.CutV.Gen(SortV.Len(), 0);  Sweep.PhiV.Gen(SortV.Len(), 0);
+  for (int i = 0; i < SortV.Len(); i++) {
+    RankV[Work.ProbIdxV[SortV[i].Val2]] = i; }
+  int Vol = 0, Cut = 0;
+  for (int i = 0; i < SortV.Len(); i++) {
+    const int Idx = Work.ProbIdxV[SortV[i].Val2];
+    const int OutDeg = GetDeg(Idx);
+    Sweep.NIdV.Add(NIdV[Idx]);
+    if (i == 0) {
+      Vol = OutDeg;  Cut = OutDeg;
+      Sweep.VolV.Add(Vol);  Sweep.CutV.Add(Cut);  Sweep.PhiV.Add(1.0);
+      continue;
+    }
+    int CutSz = OutDeg; // edges outside
+    for (int e = OffV[Idx]; e < OffV[Idx+1]; e++) {
+      const int Rank = RankV[NbrV[e]];
+      if (Rank > -1 && Rank < i) { CutSz -= 2; }
+    }
+    Vol += OutDeg;  Cut += CutSz;
+    double Phi = 1.0;
+    if (Vol < Edges2) {
+      if (2*Vol > Edges2) { Phi = Cut / double(Edges2-Vol); }
+      else { Phi = Cut / double(Vol); }
+    }
+    IAssert((Phi+1e-6) >= double(1.0)/double(i*(i+1)+1)); // conductance is worse than the best possible
+    Sweep.VolV.Add(Vol);  Sweep.CutV.Add(Cut);  Sweep.PhiV.Add(Phi);
+  }
+}
+
+void TLocClustDense::FindBestCut(const int& SeedIdx, const int& ClustSz, TWork& Work, TSweep& Sweep) const {
+  Sweep.SeedNId = NIdV[SeedIdx];
+  ApproxPageRank(SeedIdx, 1.0/double(ClustSz), Work);
+  SupportSweep(Work, Sweep);
+  double MaxPhi = TFlt::Mx;
+  Sweep.BestCutIdx = -1;
+  for (int i = 0; i < Sweep.PhiV.Len(); i++) {
+    if (Sweep.PhiV[i] < MaxPhi) { MaxPhi = Sweep.PhiV[i];  Sweep.BestCutIdx = i; } }
+  // clean the workspace for the next seed
+  for (int i = 0; i < Work.ProbIdxV.Len(); i++) {
+    Work.ProbV[Work.ProbIdxV[i]] = 0.0;  Work.RankV[Work.ProbIdxV[i]] = -1; }
+  for (int i = 0; i < Work.ResIdxV.Len(); i++) {
+    Work.ResV[Work.ResIdxV[i]] = 0.0; }
+  Work.ProbIdxV.Clr(false);  Work.ResIdxV.Clr(false);
+}
+
 //////////////////////////////////////////////////
 // Local Clustering Statistics
 
@@ -297,7 +426,8 @@ void TLocClustStat::Clr() {
   BagOfWhiskerV.Clr(false); // (Size, Conductance) of bag of whiskers clusters
 }
 
-void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const bool& SaveAllCond, const bool& SaveBestNodesAtK) {
+// seeds are drawn serially and run in parallel batches, the sweeps of a batch are added in the seed order
+void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const bool& SaveAllCond, const bool& SaveBestNodesAtK, const double& MxSecs) {
   Graph = TSnap::GetMxWcc(_Graph);
   const int Nodes = Graph->GetNodes();
   const int Edges = Graph->GetEdges();
@@ -307,13 +437,20 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
   printf("  Coverage: %d\n", Coverage());
   printf("  SizeFrac: %g\n\n", SizeFrac());
   TExeTm TotTm;
+  const uint64 StartMSecs = TTm::GetCurUniMSecs();
   Clr();
-  TLocClust Clust(Graph, Alpha);
+  const TLocClustDense DenseClust(Graph, Alpha);
+  TVec<TLocClustDense::TWork> WorkV(GetThreads());
+  const int BatchSz = 16*GetThreads();
+  TVec<TLocClustDense::TSweep> BatchV(BatchSz);
+  TIntV SeedV(BatchSz);
+  TRnd Rnd(1 + TInt::Rnd.GetUniDevInt(TInt::Mx - 1)); // seeds do not depend on the random numbers used while sorting
+  TFltV BestPhiV(Nodes+1);  BestPhiV.PutAll(TFlt::Mx); // conductance of BestCutH at each size
   BestCut.CutNIdV.Clr(false); 
   BestCut.CutSz=-1;  BestCut.Edges=-1;
   double BestPhi = TFlt::Mx;
   int prevK=-1;
-  bool NextDone=false;
+  bool NextDone=false, TimeOut=false;
   if (SaveBestNodesAtK) { // fill buckets (only store nodes in clusters for sizes in SizeBucketSet)
     SizeBucketSet.Clr();
     double PrevBPos = 1, BPos = 1;
@@ -331,11 +468,20 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
     if (NextDone) { break; } // done
     if (K+1 > 2*Graph->GetEdges()) { K = Graph->GetEdges(); NextDone=true; }
     //if (K+1 > Graph->GetEdges()) { K = Graph->GetEdges(); NextDone=true; }
-    TExeTm ExeTm, IterTm;
+    TExeTm ExeTm;
     double MeanSz=0.0, MeanVol=0.0, Count=0.0;
     for (int run = 0; run < Runs; run++) {
-      const int SeedNId = Graph->GetRndNId();  IterTm.Tick();
-      Clust.FindBestCut(SeedNId, K, SizeFrac);
+      const int BatchN = run % BatchSz;
+      if (BatchN == 0) { // sweeps of the next batch of seeds
+        if (MxSecs > 0 && TTm::GetCurUniMSecs() - StartMSecs > 1000.0*MxSecs) { TimeOut = true;  break; }
+        const int Batch = TMath::Mn(BatchSz, Runs-run);
+        for (int b = 0; b < Batch; b++) { SeedV[b] = Rnd.GetUniDevInt(DenseClust.GetNodes()); }
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int b = 0; b < Batch; b++) {
+          DenseClust.FindBestCut(SeedV[b], K, WorkV[GetThreadN()], BatchV[b]); }
+      }
+      const TLocClustDense::TSweep& Clust = BatchV[BatchN];
+      const int SeedNId = Clust.SeedNId;
       const int Sz = Clust.BestCutNodes();
       const int Vol = Clust.GetCutVol();
       const double Phi = TMath::Round(Clust.GetCutPhi(), 4);
@@ -367,7 +513,8 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
         //bool TAKE=false;  if (! BestCutH.IsKey(size)) { TAKE=true; }
         //else { BestCutH.GetDat(size).GetFracDegOut(Graph, MxFrac, AvgFrac, MedianFrac, Pct9Frac, Flake);  if (MxFrac >= phi) { TAKE = true; } }
         // if (TAKE) {
-        if (! BestCutH.IsKey(size) || BestCutH.GetDat(size).GetPhi() >= phi) { //new best cut (size, edges inside and nodes)
+        if (BestPhiV[size] >= phi) { //new best cut (size, edges inside and nodes)
+          BestPhiV[size] = phi;
           BestCutH.AddDat(size, TCutInfo(size, edges, cut));  // for every size store best cut (NIds inside the cut)
           if (SaveBestNodesAtK) { // store node ids in best community for each size k
             if (! SizeBucketSet.Empty() && ! SizeBucketSet.IsKey(size)) { continue; } // only save best clusters at SizeBucketSet
@@ -392,6 +539,8 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
     MeanSz/=Count;  MeanVol/=Count;
     printf("  Graph(%d, %d)  ", Nodes, Edges);
     printf("       mean:  sz: %.2f  vol: %.2f [%s] %s\n", MeanSz, MeanVol, ExeTm.GetStr(), TExeTm::GetCurTm());
+    if (TimeOut) {
+      printf("  Time limit of %gs reached at K: %d\n", MxSecs, K);  break; }
   }
   SizePhiH.SortByKey();
   for (int k = 0; k < SizePhiH.Len(); k++) { 
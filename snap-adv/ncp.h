@@ -4,6 +4,7 @@
 #include "Snap.h"
 
 class TLocClust;
+class TLocClustDense;
 class TLocClustStat;
 class TNcpGraphsBase;
 
@@ -90,6 +91,60 @@ public:
   friend class TLocClustStat;
 };
 
+//#///////////////////////////////////////////////
+/// Local Spectral Clustering over dense node indices.
+/// Computes the same sweeps as TLocClust::FindBestCut(). The graph is kept in CSR form, and the PageRank
+/// and residual vectors are dense arrays that are reset after every seed. This way one workspace per
+/// thread serves any number of seeds, and TLocClustStat::Run() can run the seeds in parallel.
+class TLocClustDense {
+public:
+  /// Per-thread workspace of ApproxPageRank() and SupportSweep(). It is clean (all zero) between seeds.
+  class TWork {
+  public:
+    TFltV ProbV, ResV;      // PageRank and residual of each node index
+    TIntV ProbIdxV, ResIdxV; // indices with a PageRank or residual value (in the order they got it)
+    TIntV RankV;            // position of the index in the sweep (-1 if not in ProbIdxV)
+    TIntQ NodeQ;
+    TFltIntPrV SortV;
+  };
+  /// Sweep around one seed node. Holds the same vectors as TLocClust after FindBestCut().
+  class TSweep {
+  public:
+    TInt SeedNId;
+    TIntV NIdV, VolV, CutV;  // node ids in the sweep order, volume and cut size of the first K nodes
+    TFltV PhiV;              // conductance of the first K nodes
+    TInt BestCutIdx;         // index of the minimum conductance cut
+  public:
+    TSweep() : SeedNId(-1), BestCutIdx(-1) { }
+    int Len() const { return VolV.Len(); }
+    int GetVol(const int& Nodes) const { return VolV[Nodes]; }
+    int GetCut(const int& Nodes) const { return CutV[Nodes]; }
+    double GetPhi(const int& ValId) const { return PhiV[ValId]; }
+    const TIntV& GetNIdV() const { return NIdV; }
+    const TFltV& GetPhiV() const { return PhiV; }
+    int BestCut() const { return BestCutIdx; }
+    int BestCutNodes() const { return BestCutIdx+1; }
+    int GetCutVol() const { return GetVol(BestCut()); }
+    double GetCutPhi() const { return GetPhi(BestCut()); }
+  };
+private:
+  int Nodes, Edges2;       // Nodes, 2*edges in Graph
+  double Alpha;            // PageRank jump probability
+  TIntV NIdV;              // node id of each node index
+  TIntV OffV, NbrV;        // neighbors of index i are NbrV[OffV[i]...OffV[i+1]-1]
+private:
+  int GetDeg(const int& Idx) const { return OffV[Idx+1]-OffV[Idx]; }
+  int ApproxPageRank(const int& SeedIdx, const double& Eps, TWork& Work) const;
+  void SupportSweep(TWork& Work, TSweep& Sweep) const;
+public:
+  TLocClustDense(const PUNGraph& Graph, const double& AlphaVal);
+  int GetNodes() const { return Nodes; }
+  /// Node id of the node index Idx (indices are 0...GetNodes()-1).
+  int GetNId(const int& Idx) const { return NIdV[Idx]; }
+  /// Finds the minimum conductance cut around the node index SeedIdx, see TLocClust::FindBestCut(). Thread safe if every thread has its own Work.
+  void FindBestCut(const int& SeedIdx, const int& ClustSz, TWork& Work, TSweep& Sweep) const;
+};
+
 //#///////////////////////////////////////////////
 /// Local-Spectral-Clustering statistics of a given Graph.
 class TLocClustStat {
@@ -162,7 +217,8 @@ public:
   void Save(TSOut& SOut) const;
   void Clr();
   void SetGraph(const PUNGraph& GraphPt) { Graph=GraphPt; }
-  void Run(const PUNGraph& Graph, const bool& SaveAllSweeps=false, const bool& SaveAllCond=false, const bool& SaveBestNodesAtK=false);
+  /// Runs local clustering from random seed nodes for cluster sizes K=KMin...KMax. The seeds are processed in parallel. If MxSecs > 0, stops after MxSecs seconds of wall-clock time.
+  void Run(const PUNGraph& Graph, const bool& SaveAllSweeps=false, const bool& SaveAllCond=false, const bool& SaveBestNodesAtK=false, const double& MxSecs=-1);
   void AddBagOfWhiskers();
   void AddCut(const TIntV& NIdV);
   void AddCut(const int& ClustSz, const double& Phi);
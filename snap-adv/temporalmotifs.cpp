@@ -7,7 +7,23 @@ TempMotifCounter::TempMotifCounter(const TStr& filename) {
   // First load the static graph
   static_graph_ = TSnap::LoadEdgeList<PNGraph>(filename, 0, 1);
   int max_nodes = static_graph_->GetMxNId();
-  temporal_data_ = TVec< THash<TInt, TIntV> >(max_nodes);
+
+  // Lay out the static edges by source node.  Out-neighbors of a TNGraph node
+  // are already sorted.
+  nbr_off_ = TIntV(max_nodes + 1);
+  nbr_off_.PutAll(0);
+  for (TNGraph::TNodeI it = static_graph_->BegNI();
+       it < static_graph_->EndNI(); it++) {
+    nbr_off_[it.GetId() + 1] = it.GetOutDeg();
+  }
+  for (int u = 0; u < max_nodes; u++) { nbr_off_[u + 1] += nbr_off_[u]; }
+  dst_ = TIntV(nbr_off_[max_nodes]);
+  for (TNGraph::TNodeI it = static_graph_->BegNI();
+       it < static_graph_->EndNI(); it++) {
+    for (int i = 0; i < it.GetOutDeg(); i++) {
+      dst_[nbr_off_[it.GetId()] + i] = it.GetOutNId(i);
+    }
+  }
 
   // Formulate input File Format:
   //   source_node destination_node timestamp
@@ -19,18 +35,49 @@ TempMotifCounter::TempMotifCounter(const TStr& filename) {
 
   // Load the temporal graph
   PTable data_ptr = TTable::LoadSS(temp_graph_schema, filename, &context, ' ');
-  TInt src_idx = data_ptr->GetColIdx("source");
-  TInt dst_idx = data_ptr->GetColIdx("destination");
-  TInt tim_idx = data_ptr->GetColIdx("time");
+  TInt64 src_idx = data_ptr->GetColIdx("source");
+  TInt64 dst_idx = data_ptr->GetColIdx("destination");
+  TInt64 tim_idx = data_ptr->GetColIdx("time");
+
+  // Count the temporal edges along each static edge, then place the timestamps
+  // of every static edge contiguously.
+  ts_off_ = TInt64V(dst_.Len() + 1);
+  ts_off_.PutAll(0);
   for (TRowIterator RI = data_ptr->BegRI(); RI < data_ptr->EndRI(); RI++) {
-    TInt row_idx = RI.GetRowIdx();
-    int src = data_ptr->GetIntValAtRowIdx(src_idx, row_idx).Val;
-    int dst = data_ptr->GetIntValAtRowIdx(dst_idx, row_idx).Val;
-    int tim = data_ptr->GetIntValAtRowIdx(tim_idx, row_idx).Val;
-    temporal_data_[src](dst).Add(tim);
+    int edge = GetEdgeIdx(RI.GetIntAttr(src_idx).Val, RI.GetIntAttr(dst_idx).Val);
+    IAssert(edge >= 0);
+    ts_off_[edge + 1]++;
+  }
+  for (int e = 0; e < dst_.Len(); e++) { ts_off_[e + 1] += ts_off_[e]; }
+  timestamps_.Gen(ts_off_.Last());
+  TInt64V next = ts_off_;
+  for (TRowIterator RI = data_ptr->BegRI(); RI < data_ptr->EndRI(); RI++) {
+    int edge = GetEdgeIdx(RI.GetIntAttr(src_idx).Val, RI.GetIntAttr(dst_idx).Val);
+    timestamps_[next[edge]++] = RI.GetIntAttr(tim_idx).Val;
+  }
+  // Sort once here so that counting never has to sort a single static edge
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int e = 0; e < dst_.Len(); e++) {
+    timestamps_.QSort(ts_off_[e], ts_off_[e + 1] - 1, true);
   }
 }
 
+int TempMotifCounter::GetNumThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+int TempMotifCounter::GetThreadId() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
 void TempMotifCounter::GetAllNodes(TIntV& nodes) {
   nodes = TIntV();
   for (TNGraph::TNodeI it = static_graph_->BegNI();
@@ -39,8 +86,44 @@ void TempMotifCounter::GetAllNodes(TIntV& nodes) {
   }
 }
 
+int TempMotifCounter::GetEdgeIdx(int u, int v) {
+  // Binary search over the sorted out-neighbors of u
+  int lo = nbr_off_[u];
+  int hi = nbr_off_[u + 1];
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (dst_[mid] < v) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < nbr_off_[u + 1] && dst_[lo] == v) ? lo : -1;
+}
+
+int TempMotifCounter::GetUndirEdgeIdx(int u, int v) {
+  int edge = GetEdgeIdx(MIN(u, v), MAX(u, v));
+  return edge >= 0 ? edge : GetEdgeIdx(MAX(u, v), MIN(u, v));
+}
+
+void TempMotifCounter::GetEventRange(int u, int v, int64& beg, int64& end) {
+  int edge = GetEdgeIdx(u, v);
+  if (edge < 0) {
+    beg = end = 0;
+  } else {
+    beg = ts_off_[edge];
+    end = ts_off_[edge + 1];
+  }
+}
+
+int64 TempMotifCounter::GetNumEvents(int u, int v) {
+  int64 beg, end;
+  GetEventRange(u, v, beg, end);
+  return end - beg;
+}
+
 bool TempMotifCounter::HasEdges(int u, int v) {
-  return temporal_data_[u].IsKey(v);
+  return GetNumEvents(u, v) > 0;
 }
 
 void TempMotifCounter::GetAllNeighbors(int node, TIntV& nbrs) {
@@ -80,9 +163,12 @@ void TempMotifCounter::GetAllStaticTriangles(TIntV& Us, TIntV& Vs, TIntV& Ws) {
   }
 
   // Get triangles centered at a given node where that node is the smallest in
-  // the degree ordering.
+  // the degree ordering.  Each thread collects its own triangles.
+  int num_threads = GetNumThreads();
+  TVec<TIntV> thread_us(num_threads), thread_vs(num_threads), thread_ws(num_threads);
   #pragma omp parallel for schedule(dynamic)  
   for (int node_id = 0; node_id < nodes.Len(); node_id++) {
+    int thread_id = GetThreadId();
     int src = nodes[node_id];
     int src_pos = order[src];
     
@@ -101,34 +187,32 @@ void TempMotifCounter::GetAllStaticTriangles(TIntV& Us, TIntV& Vs, TIntV& Ws) {
         int dst2 = neighbors_higher[ind2];
         // Check for triangle formation
         if (static_graph_->IsEdge(dst1, dst2) || static_graph_->IsEdge(dst2, dst1)) {
-          #pragma omp critical
-          {
-            Us.Add(src);
-            Vs.Add(dst1);
-            Ws.Add(dst2);
-          }
+          thread_us[thread_id].Add(src);
+          thread_vs[thread_id].Add(dst1);
+          thread_ws[thread_id].Add(dst2);
         }
       }
     }
   }
+  for (int t = 0; t < num_threads; t++) {
+    Us.AddV(thread_us[t]);
+    Vs.AddV(thread_vs[t]);
+    Ws.AddV(thread_ws[t]);
+  }
 }
 
-void TempMotifCounter::Count3TEdge23Node(double delta, Counter2D& counts) {
-  // This is imply a wrapper function around the counting methods to produce
-  // counts in the same way that they were represented in the paper.  This makes
-  // it easy to reproduce results and allow SNAP users to make the same
-  // measurements on their temporal network data.
+// Arranges the two-node, star and triad counts into counts(i, j) for motif
+// M_{i,j}, the format shared by TempMotifCounter::Count3TEdge23Node() and
+// OnlineTempMotifCounter::GetCounts().
+static void Get23NodeCounts(Counter2D& edge_counts, Counter3D& pre_counts,
+                            Counter3D& pos_counts, Counter3D& mid_counts,
+                            Counter3D& triad_counts, Counter2D& counts) {
   counts = Counter2D(6, 6);
-  
-  Counter2D edge_counts;
-  Count3TEdge2Node(delta, edge_counts);
   counts(4, 0) = edge_counts(0, 0);
   counts(4, 1) = edge_counts(0, 1);
   counts(5, 0) = edge_counts(1, 0);
   counts(5, 1) = edge_counts(1, 1);
 
-  Counter3D pre_counts, pos_counts, mid_counts;
-  Count3TEdge3NodeStars(delta, pre_counts, pos_counts, mid_counts);
   counts(0, 0) = mid_counts(1, 1, 1);
   counts(0, 1) = mid_counts(1, 1, 0);
   counts(0, 4) = pos_counts(1, 1, 0);
@@ -154,8 +238,6 @@ void TempMotifCounter::Count3TEdge23Node(double delta, Counter2D& counts) {
   counts(5, 4) = pre_counts(1, 1, 0);
   counts(5, 5) = pre_counts(1, 1, 1);  
 
-  Counter3D triad_counts;
-  Count3TEdgeTriads(delta, triad_counts);
   counts(0, 2) = triad_counts(0, 0, 0);
   counts(0, 3) = triad_counts(0, 0, 1);
   counts(1, 2) = triad_counts(0, 1, 0);
@@ -166,6 +248,21 @@ void TempMotifCounter::Count3TEdge23Node(double delta, Counter2D& counts) {
   counts(3, 5) = triad_counts(1, 1, 1);
 }
 
+void TempMotifCounter::Count3TEdge23Node(double delta, Counter2D& counts) {
+  // This is imply a wrapper function around the counting methods to produce
+  // counts in the same way that they were represented in the paper.  This makes
+  // it easy to reproduce results and allow SNAP users to make the same
+  // measurements on their temporal network data.
+  Counter2D edge_counts;
+  Count3TEdge2Node(delta, edge_counts);
+  Counter3D pre_counts, pos_counts, mid_counts;
+  Count3TEdge3NodeStars(delta, pre_counts, pos_counts, mid_counts);
+  Counter3D triad_counts;
+  Count3TEdgeTriads(delta, triad_counts);
+  Get23NodeCounts(edge_counts, pre_counts, pos_counts, mid_counts, triad_counts,
+                  counts);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Two-node (static edge) counting methods
 void TempMotifCounter::Count3TEdge2Node(double delta, Counter2D& counts) {
@@ -179,38 +276,54 @@ void TempMotifCounter::Count3TEdge2Node(double delta, Counter2D& counts) {
       undir_edges.Add(TIntPair(src, dst));
     }
   }
-  counts = Counter2D(2, 2);
-  #pragma omp parallel for schedule(dynamic)
+  // Process the edges with the most temporal edges first
+  TVec<TInt64Pr> work(undir_edges.Len());
   for (int i = 0; i < undir_edges.Len(); i++) {
     TIntPair edge = undir_edges[i];
+    work[i] = TInt64Pr(GetNumEvents(edge.Key, edge.Dat)
+                          + GetNumEvents(edge.Dat, edge.Key), i);
+  }
+  work.Sort(false);
+
+  int num_threads = GetNumThreads();
+  TVec<Counter2D> thread_counts(num_threads);
+  for (int t = 0; t < num_threads; t++) { thread_counts[t] = Counter2D(2, 2); }
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < work.Len(); i++) {
+    TIntPair edge = undir_edges[int(work[i].Val2)];
     Counter3D local;
     Count3TEdge2Node(edge.Key, edge.Dat, delta, local);
-    #pragma omp critical
-    {
-      counts(0, 0) += local(0, 1, 0) + local(1, 0, 1);  // M_{5,1}
-      counts(0, 1) += local(1, 0, 0) + local(0, 1, 1);  // M_{5,2}
-      counts(1, 0) += local(0, 0, 0) + local(1, 1, 1);  // M_{6,1}
-      counts(1, 1) += local(0, 0, 1) + local(1, 1, 0);  // M_{6,2}
-    }
+    Counter2D& thread_counter = thread_counts[GetThreadId()];
+    thread_counter(0, 0) += local(0, 1, 0) + local(1, 0, 1);  // M_{5,1}
+    thread_counter(0, 1) += local(1, 0, 0) + local(0, 1, 1);  // M_{5,2}
+    thread_counter(1, 0) += local(0, 0, 0) + local(1, 1, 1);  // M_{6,1}
+    thread_counter(1, 1) += local(0, 0, 1) + local(1, 1, 0);  // M_{6,2}
   }
+  counts = Counter2D(2, 2);
+  for (int t = 0; t < num_threads; t++) { counts.Add(thread_counts[t]); }
 }
 
 void TempMotifCounter::Count3TEdge2Node(int u, int v, double delta,
                                         Counter3D& counts) {
-  // Sort event list by time
-  TVec<TIntPair> combined;
-  AddStarEdges(combined, u, v, 0);
-  AddStarEdges(combined, v, u, 1);
-  combined.Sort();
+  // Merge the two sorted event lists by time, with u --> v first on ties
+  int64 uv, uv_end, vu, vu_end;
+  GetEventRange(u, v, uv, uv_end);
+  GetEventRange(v, u, vu, vu_end);
+  int num_events = int(uv_end - uv + vu_end - vu);
+  TIntV in_out(num_events);
+  TIntV timestamps(num_events);
+  for (int k = 0; k < num_events; k++) {
+    if (vu == vu_end || (uv < uv_end && timestamps_[uv] <= timestamps_[vu])) {
+      in_out[k] = 0;
+      timestamps[k] = timestamps_[uv++];
+    } else {
+      in_out[k] = 1;
+      timestamps[k] = timestamps_[vu++];
+    }
+  }
 
   // Get the counts
   ThreeTEdgeMotifCounter counter(2);
-  TIntV in_out(combined.Len());
-  TIntV timestamps(combined.Len());
-  for (int k = 0; k < combined.Len(); k++) {
-    in_out[k] = combined[k].Dat;
-    timestamps[k] = combined[k].Key;
-  }
   counter.Count(in_out, timestamps, delta, counts);
 }
 
@@ -218,11 +331,10 @@ void TempMotifCounter::Count3TEdge2Node(int u, int v, double delta,
 // Star counting methods
 void TempMotifCounter::AddStarEdges(TVec<TIntPair>& combined, int u, int v,
                                     int key) {
-  if (HasEdges(u, v)) {
-    const TIntV& timestamps = temporal_data_[u].GetDat(v);
-    for (int i = 0; i < timestamps.Len(); i++) {
-      combined.Add(TIntPair(timestamps[i], key));
-    }
+  int64 beg, end;
+  GetEventRange(u, v, beg, end);
+  for (int64 i = beg; i < end; i++) {
+    combined.Add(TIntPair(timestamps_[i], key));
   }
 }
 
@@ -281,16 +393,15 @@ void TempMotifCounter::Count3TEdge3NodeStarsNaive(
   }
 }
 
-void TempMotifCounter::AddStarEdgeData(TVec<TIntPair>& ts_indices,
+void TempMotifCounter::AddStarEdgeData(TIntPrV& ts_indices,
                                        TVec<StarEdgeData>& events,
                                        int& index, int u, int v, int nbr, int key) {
-  if (HasEdges(u, v)) {
-    const TIntV& ts_vec = temporal_data_[u].GetDat(v);
-    for (int j = 0; j < ts_vec.Len(); ++j) {
-      ts_indices.Add(TIntPair(ts_vec[j], index));
-      events.Add(StarEdgeData(nbr, key));
-      index++;
-    }
+  int64 beg, end;
+  GetEventRange(u, v, beg, end);
+  for (int64 j = beg; j < end; ++j) {
+    ts_indices.Add(TIntPr(timestamps_[j], index));
+    events.Add(StarEdgeData(nbr, key));
+    index++;
   }
 }
 
@@ -299,17 +410,43 @@ void TempMotifCounter::Count3TEdge3NodeStars(double delta, Counter3D& pre_counts
                                              Counter3D& mid_counts) {
   TIntV centers;
   GetAllNodes(centers);
-  pre_counts = Counter3D(2, 2, 2);
-  pos_counts = Counter3D(2, 2, 2);
-  mid_counts = Counter3D(2, 2, 2);
+  // Process the centers with the most adjacent temporal edges first so that
+  // high-degree centers do not end up as the tail of the parallel loop.
+  TVec<TInt64Pr> work(centers.Len());
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int c = 0; c < centers.Len(); c++) {
+    int center = centers[c];
+    int64 num_events = 0;
+    TNGraph::TNodeI NI = static_graph_->GetNI(center);
+    for (int i = 0; i < NI.GetOutDeg(); i++) {
+      num_events += GetNumEvents(center, NI.GetOutNId(i));
+    }
+    for (int i = 0; i < NI.GetInDeg(); i++) {
+      num_events += GetNumEvents(NI.GetInNId(i), center);
+    }
+    work[c] = TInt64Pr(num_events, c);
+  }
+  work.Sort(false);
+
+  int num_threads = GetNumThreads();
+  TVec<Counter3D> thread_pre(num_threads), thread_pos(num_threads),
+    thread_mid(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    thread_pre[t] = Counter3D(2, 2, 2);
+    thread_pos[t] = Counter3D(2, 2, 2);
+    thread_mid[t] = Counter3D(2, 2, 2);
+  }
   // Get counts for each node as the center
   #pragma omp parallel for schedule(dynamic)  
-  for (int c = 0; c < centers.Len(); c++) {
+  for (int c = 0; c < work.Len(); c++) {
     // Gather all adjacent events
-    int center = centers[c];
-    TVec<TIntPair> ts_indices;
+    int center = centers[int(work[c].Val2)];
+    int thread_id = GetThreadId();
+    Counter3D& local_pre = thread_pre[thread_id];
+    Counter3D& local_pos = thread_pos[thread_id];
+    Counter3D& local_mid = thread_mid[thread_id];
+    TIntPrV ts_indices;
     TVec<StarEdgeData> events;
-    TNGraph::TNodeI NI = static_graph_->GetNI(center);
     int index = 0;
     TIntV nbrs;
     GetAllNeighbors(center, nbrs);
@@ -324,22 +461,20 @@ void TempMotifCounter::Count3TEdge3NodeStars(double delta, Counter3D& pre_counts
     TIntV timestamps;
     TVec<StarEdgeData> ordered_events;
     for (int j = 0; j < ts_indices.Len(); j++) {
-      timestamps.Add(ts_indices[j].Key);
-      ordered_events.Add(events[ts_indices[j].Dat]);
+      timestamps.Add(ts_indices[j].Val1);
+      ordered_events.Add(events[ts_indices[j].Val2]);
     }
     
     ThreeTEdgeStarCounter tesc(nbr_index);
     // dirs: outgoing --> 0, incoming --> 1
     tesc.Count(ordered_events, timestamps, delta);
-    #pragma omp critical
-    { // Update counts
-      for (int dir1 = 0; dir1 < 2; ++dir1) {
-        for (int dir2 = 0; dir2 < 2; ++dir2) {
-          for (int dir3 = 0; dir3 < 2; ++dir3) {
-            pre_counts(dir1, dir2, dir3) += tesc.PreCount(dir1, dir2, dir3);
-            pos_counts(dir1, dir2, dir3) += tesc.PosCount(dir1, dir2, dir3);
-            mid_counts(dir1, dir2, dir3) += tesc.MidCount(dir1, dir2, dir3);
-          }
+    // Update counts
+    for (int dir1 = 0; dir1 < 2; ++dir1) {
+      for (int dir2 = 0; dir2 < 2; ++dir2) {
+        for (int dir3 = 0; dir3 < 2; ++dir3) {
+          local_pre(dir1, dir2, dir3) += tesc.PreCount(dir1, dir2, dir3);
+          local_pos(dir1, dir2, dir3) += tesc.PosCount(dir1, dir2, dir3);
+          local_mid(dir1, dir2, dir3) += tesc.MidCount(dir1, dir2, dir3);
         }
       }
     }
@@ -349,20 +484,26 @@ void TempMotifCounter::Count3TEdge3NodeStars(double delta, Counter3D& pre_counts
       int nbr = nbrs[nbr_id];
       Counter3D edge_counts;
       Count3TEdge2Node(center, nbr, delta, edge_counts);
-      #pragma omp critical
-      {
-        for (int dir1 = 0; dir1 < 2; ++dir1) {
-          for (int dir2 = 0; dir2 < 2; ++dir2) {
-            for (int dir3 = 0; dir3 < 2; ++dir3) {
-              pre_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
-              pos_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
-              mid_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
-            }
+      for (int dir1 = 0; dir1 < 2; ++dir1) {
+        for (int dir2 = 0; dir2 < 2; ++dir2) {
+          for (int dir3 = 0; dir3 < 2; ++dir3) {
+            local_pre(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
+            local_pos(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
+            local_mid(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
           }
         }
       }
     }
   }
+
+  pre_counts = Counter3D(2, 2, 2);
+  pos_counts = Counter3D(2, 2, 2);
+  mid_counts = Counter3D(2, 2, 2);
+  for (int t = 0; t < num_threads; t++) {
+    pre_counts.Add(thread_pre[t]);
+    pos_counts.Add(thread_pos[t]);
+    mid_counts.Add(thread_mid[t]);
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -429,96 +570,103 @@ void TempMotifCounter::Count3TEdgeTriadsNaive(double delta, Counter3D& counts) {
 }
 
 void TempMotifCounter::AddTriadEdgeData(TVec<TriadEdgeData>& events,
-                                        TVec<TIntPair>& ts_indices,
+                                        TIntPrV& ts_indices,
                                         int& index, int u, int v, int nbr,
                                         int key1, int key2) {
-  if (HasEdges(u, v)) {
-    const TIntV& timestamps = temporal_data_[u].GetDat(v);
-    for (int i = 0; i < timestamps.Len(); i++) {
-      ts_indices.Add(TIntPair(timestamps[i], index));
-      events.Add(TriadEdgeData(nbr, key1, key2));
-      ++index;
-    }
+  int64 beg, end;
+  GetEventRange(u, v, beg, end);
+  for (int64 i = beg; i < end; i++) {
+    ts_indices.Add(TIntPr(timestamps_[i], index));
+    events.Add(TriadEdgeData(nbr, key1, key2));
+    ++index;
   }
 }
 
 void TempMotifCounter::Count3TEdgeTriads(double delta, Counter3D& counts) {
-  counts = Counter3D(2, 2, 2);
-
-  // Get the counts on each undirected edge
-  TVec< THash<TInt, TInt> > edge_counts(static_graph_->GetMxNId());
-  TVec< THash<TInt, TIntV> > assignments(static_graph_->GetMxNId());
-  for (TNGraph::TEdgeI it = static_graph_->BegEI();
-       it < static_graph_->EndEI(); it++) {
-    int src = it.GetSrcNId();
-    int dst = it.GetDstNId();
-    int min_node = MIN(src, dst);
-    int max_node = MAX(src, dst);
-    edge_counts[min_node](max_node) += temporal_data_[src](dst).Len();
-    assignments[min_node](max_node) = TIntV();
+  // Get the counts on each undirected edge, stored at the position of one of
+  // its static edges in the temporal edge index
+  TInt64V edge_counts(dst_.Len());
+  edge_counts.PutAll(0);
+  for (int u = 0; u < nbr_off_.Len() - 1; u++) {
+    for (int e = nbr_off_[u]; e < nbr_off_[u + 1]; e++) {
+      edge_counts[GetUndirEdgeIdx(u, dst_[e])] += ts_off_[e + 1] - ts_off_[e];
+    }
   }
   
   // Assign triangles to the edge with the most events
   TIntV Us, Vs, Ws;
   GetAllStaticTriangles(Us, Vs, Ws);
-  #pragma omp parallel for schedule(dynamic)
+  TIntV assigned_edge(Us.Len());
+  #pragma omp parallel for schedule(dynamic, 1024)
   for (int i = 0; i < Us.Len(); i++) {
     int u = Us[i];
     int v = Vs[i];
     int w = Ws[i];
-    int counts_uv = edge_counts[MIN(u, v)].GetDat(MAX(u, v));
-    int counts_uw = edge_counts[MIN(u, w)].GetDat(MAX(u, w));
-    int counts_vw = edge_counts[MIN(v, w)].GetDat(MAX(v, w));
+    int uv = GetUndirEdgeIdx(u, v);
+    int uw = GetUndirEdgeIdx(u, w);
+    int vw = GetUndirEdgeIdx(v, w);
+    int64 counts_uv = edge_counts[uv];
+    int64 counts_uw = edge_counts[uw];
+    int64 counts_vw = edge_counts[vw];
     if        (counts_uv >= MAX(counts_uw, counts_vw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(u, v)].GetDat(MAX(u, v));
-        assignment.Add(w);
-      }
+      assigned_edge[i] = uv;
     } else if (counts_uw >= MAX(counts_uv, counts_vw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(u, w)].GetDat(MAX(u, w));
-        assignment.Add(v);      
-      }
-    } else if (counts_vw >= MAX(counts_uv, counts_uw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(v, w)].GetDat(MAX(v, w));
-        assignment.Add(u);              
-      }
+      assigned_edge[i] = uw;
+    } else {
+      assigned_edge[i] = vw;
     }
   }
+  TVec<TIntV> assignments(dst_.Len());
+  for (int i = 0; i < Us.Len(); i++) {
+    int e = assigned_edge[i];
+    int u = Us[i];
+    int v = Vs[i];
+    int w = Ws[i];
+    // Store the third node of the triangle
+    if (e != GetUndirEdgeIdx(u, v)) {
+      if (e == GetUndirEdgeIdx(u, w)) { w = v; } else { w = u; }
+    }
+    assignments[e].Add(w);
+  }
 
+  // Get the edges with assigned triangles as (min node, max node) pairs and
+  // process the ones with the most events to count first
   TVec<TIntPair> all_edges;
-  TIntV all_nodes;
-  GetAllNodes(all_nodes);  
-  for (int node_id = 0; node_id < all_nodes.Len(); node_id++) {
-    int u = all_nodes[node_id];
-    TIntV nbrs;
-    GetAllNeighbors(u, nbrs);
-    for (int nbr_id = 0; nbr_id < nbrs.Len(); nbr_id++) {
-      int v = nbrs[nbr_id];
-      if (assignments[u].IsKey(v) && assignments[u].GetDat(v).Len() > 0) {
-        all_edges.Add(TIntPair(u, v));
+  TInt64V work;
+  for (int u = 0; u < nbr_off_.Len() - 1; u++) {
+    for (int e = nbr_off_[u]; e < nbr_off_[u + 1]; e++) {
+      int v = dst_[e];
+      if (assignments[e].Len() == 0 || GetUndirEdgeIdx(u, v) != e) { continue; }
+      // Triangles found in parallel come in arbitrary order, which decides
+      // the order of simultaneous events below
+      assignments[e].Sort();
+      int64 num_events = edge_counts[e];
+      for (int w_id = 0; w_id < assignments[e].Len(); w_id++) {
+        int w = assignments[e][w_id];
+        num_events += edge_counts[GetUndirEdgeIdx(u, w)]
+          + edge_counts[GetUndirEdgeIdx(v, w)];
       }
+      all_edges.Add(TIntPair(MIN(u, v), MAX(u, v)));
+      work.Add(num_events);
     }
   }
+  TVec<TInt64Pr> order(all_edges.Len());
+  for (int i = 0; i < all_edges.Len(); i++) { order[i] = TInt64Pr(work[i], i); }
+  order.Sort(false);
 
   // Count triangles on edges with the assigned neighbors
+  int num_threads = GetNumThreads();
+  TVec<Counter3D> thread_counts(num_threads);
+  for (int t = 0; t < num_threads; t++) { thread_counts[t] = Counter3D(2, 2, 2); }
   #pragma omp parallel for schedule(dynamic)
-  for (int edge_id = 0; edge_id < all_edges.Len(); edge_id++) {
-    TIntPair edge = all_edges[edge_id];
+  for (int edge_id = 0; edge_id < order.Len(); edge_id++) {
+    TIntPair edge = all_edges[int(order[edge_id].Val2)];
     int u = edge.Key;
     int v = edge.Dat;
-    // Continue if no assignment
-    if (!assignments[u].IsKey(v)) { continue; }
-    TIntV& uv_assignment = assignments[u].GetDat(v);
-    // Continue if no data
-    if (uv_assignment.Len() == 0) { continue; }
+    const TIntV& uv_assignment = assignments[GetUndirEdgeIdx(u, v)];
     // Get all events on (u, v)
     TVec<TriadEdgeData> events;
-    TVec<TIntPair> ts_indices;
+    TIntPrV ts_indices;
     int index = 0;
     int nbr_index = 0;
     // Assign indices from 0, 1, ..., num_nbrs + 2
@@ -540,24 +688,260 @@ void TempMotifCounter::Count3TEdgeTriads(double delta, Counter3D& counts) {
     TIntV timestamps(ts_indices.Len());
     TVec<TriadEdgeData> sorted_events(ts_indices.Len());
     for (int i = 0; i < ts_indices.Len(); i++) {
-      timestamps[i] = ts_indices[i].Key;
-      sorted_events[i] = events[ts_indices[i].Dat];
+      timestamps[i] = ts_indices[i].Val1;
+      sorted_events[i] = events[ts_indices[i].Val2];
     }
     
-    // Get the counts and update the counter
+    // Get the counts and update the counter of this thread
     ThreeTEdgeTriadCounter tetc(nbr_index, 0, 1);
     tetc.Count(sorted_events, timestamps, delta);
-    #pragma omp critical
-    {
-      for (int dir1 = 0; dir1 < 2; dir1++) {
-        for (int dir2 = 0; dir2 < 2; dir2++) {
-          for (int dir3 = 0; dir3 < 2; dir3++) {        
-            counts(dir1, dir2, dir3) += tetc.Counts(dir1, dir2, dir3);
-          }
+    Counter3D& local = thread_counts[GetThreadId()];
+    for (int dir1 = 0; dir1 < 2; dir1++) {
+      for (int dir2 = 0; dir2 < 2; dir2++) {
+        for (int dir3 = 0; dir3 < 2; dir3++) {        
+          local(dir1, dir2, dir3) += tetc.Counts(dir1, dir2, dir3);
         }
       }
     }
   }
+  counts = Counter3D(2, 2, 2);
+  for (int t = 0; t < num_threads; t++) { counts.Add(thread_counts[t]); }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Online counting over a stream of temporal edges
+OnlineTempMotifCounter::PairData::PairData() : head(0) {
+  for (int i = 0; i < 2; i++) {
+    counts1[i] = 0;
+    for (int j = 0; j < 2; j++) {
+      counts2[i][j] = 0;
+      for (int k = 0; k < 2; k++) {
+        sum_after[i][j][k] = 0;
+        sum_before[i][j][k] = 0;
+      }
+    }
+  }
+}
+
+OnlineTempMotifCounter::NodeData::NodeData() {
+  for (int i = 0; i < 2; i++) {
+    arrived[i] = 0;
+    evicted[i] = 0;
+    for (int j = 0; j < 2; j++) { same[i][j] = 0; }
+  }
+}
+
+OnlineTempMotifCounter::OnlineTempMotifCounter(double delta) :
+    delta_(delta), last_timestamp_(TInt::Mn), next_seq_(0), head_(0) {
+  ResetCounts();
+}
+
+void OnlineTempMotifCounter::ResetCounts() {
+  edge_counts_ = Counter2D(2, 2);
+  pre_counts_ = Counter3D(2, 2, 2);
+  pos_counts_ = Counter3D(2, 2, 2);
+  mid_counts_ = Counter3D(2, 2, 2);
+  triad_counts_ = Counter3D(2, 2, 2);
+}
+
+void OnlineTempMotifCounter::GetCounts(Counter2D& counts) {
+  Get23NodeCounts(edge_counts_, pre_counts_, pos_counts_, mid_counts_,
+                  triad_counts_, counts);
+}
+
+void OnlineTempMotifCounter::AddEdge(int src, int dst, int timestamp) {
+  if (timestamp < last_timestamp_) {
+    TExcept::Throw("Temporal edges must be added in time order.");
+  }
+  last_timestamp_ = timestamp;
+  if (src == dst) { return; }
+  // Drop temporal edges that can no longer be in a motif with this one
+  while (head_ < window_.Len() &&
+         double(window_[head_].timestamp) + delta_ < double(timestamp)) {
+    PopEdge();
+  }
+
+  TIntPr key(MIN(src, dst), MAX(src, dst));
+  int dir = (src < dst) ? 0 : 1;
+  PairData empty_pair;
+  NodeData empty_node;
+  int pair_id = pairs_.GetKeyId(key);
+  const PairData& pair = (pair_id >= 0) ? pairs_[pair_id] : empty_pair;
+
+  // Two-node motifs: two earlier temporal edges on the same static edge
+  for (int dir1 = 0; dir1 < 2; dir1++) {
+    for (int dir2 = 0; dir2 < 2; dir2++) {
+      int64 count = pair.counts2[dir1][dir2];
+      if (dir1 == dir2 && dir2 == dir) {
+        edge_counts_(1, 0) += count;  // M_{6,1}
+      } else if (dir1 == dir2) {
+        edge_counts_(1, 1) += count;  // M_{6,2}
+      } else if (dir1 == dir) {
+        edge_counts_(0, 0) += count;  // M_{5,1}
+      } else {
+        edge_counts_(0, 1) += count;  // M_{5,2}
+      }
+    }
+  }
+
+  // Stars centered at either end point of the new temporal edge.  With the new
+  // edge on {c, x} and w != x, the earlier two temporal edges are on
+  //   pre: {c, w}, {c, w}
+  //   mid: {c, x}, {c, w}
+  //   pos: {c, w}, {c, x}
+  // and each count is the number of ordered pairs of kept temporal edges on the
+  // given static edges minus the pairs with both temporal edges on {c, x}.
+  for (int side = 0; side < 2; side++) {
+    int center = (side == 0) ? key.Val1 : key.Val2;
+    int node_id = nodes_.GetKeyId(center);
+    const NodeData& node = (node_id >= 0) ? nodes_[node_id] : empty_node;
+    int dir3 = dir ^ side;
+    for (int dir1 = 0; dir1 < 2; dir1++) {
+      for (int dir2 = 0; dir2 < 2; dir2++) {
+        int64 same_pair = pair.counts2[dir1 ^ side][dir2 ^ side];
+        pre_counts_(dir1, dir2, dir3) += node.same[dir1][dir2] - same_pair;
+        mid_counts_(dir1, dir2, dir3) +=
+          pair.counts1[dir1 ^ side] * node.arrived[dir2]
+          - pair.sum_after[side][dir1][dir2] - same_pair;
+        pos_counts_(dir1, dir2, dir3) += pair.sum_before[side][dir1][dir2]
+          - pair.counts1[dir2 ^ side] * node.evicted[dir1] - same_pair;
+      }
+    }
+  }
+
+  // Triads closed by the new temporal edge
+  CountTriads(src, dst);
+
+  // Add the temporal edge
+  if (pair_id < 0) {
+    nodes_.AddDat(key.Val1).nbrs.AddKey(key.Val2);
+    nodes_.AddDat(key.Val2).nbrs.AddKey(key.Val1);
+  }
+  PairData& new_pair = pairs_.AddDat(key);
+  WindowEdge edge;
+  edge.src = src;
+  edge.dst = dst;
+  edge.timestamp = timestamp;
+  for (int side = 0; side < 2; side++) {
+    NodeData& node = nodes_.GetDat((side == 0) ? key.Val1 : key.Val2);
+    int rel_dir = dir ^ side;
+    node.arrived[rel_dir]++;
+    for (int i = 0; i < 2; i++) {
+      edge.after[side][i] = node.arrived[i];
+      new_pair.sum_after[side][rel_dir][i] += node.arrived[i];
+      new_pair.sum_before[side][i][rel_dir] += node.arrived[i] - (i == rel_dir);
+      node.same[i ^ side][rel_dir] += new_pair.counts1[i];
+    }
+  }
+  for (int i = 0; i < 2; i++) { new_pair.counts2[i][dir] += new_pair.counts1[i]; }
+  new_pair.counts1[dir]++;
+  new_pair.seqs.Add(2 * next_seq_ + dir);
+  next_seq_++;
+  window_.Add(edge);
+}
+
+void OnlineTempMotifCounter::PopEdge() {
+  const WindowEdge& edge = window_[head_];
+  TIntPr key(MIN(edge.src, edge.dst), MAX(edge.src, edge.dst));
+  int dir = (edge.src < edge.dst) ? 0 : 1;
+  PairData& pair = pairs_.GetDat(key);
+  // The evicted temporal edge is the oldest one on its static edge
+  pair.counts1[dir]--;
+  for (int i = 0; i < 2; i++) { pair.counts2[dir][i] -= pair.counts1[i]; }
+  for (int side = 0; side < 2; side++) {
+    NodeData& node = nodes_.GetDat((side == 0) ? key.Val1 : key.Val2);
+    int rel_dir = dir ^ side;
+    for (int i = 0; i < 2; i++) {
+      pair.sum_after[side][rel_dir][i] -= edge.after[side][i];
+      pair.sum_before[side][i][rel_dir] -= edge.after[side][i] - (i == rel_dir);
+      node.same[rel_dir][i ^ side] -= pair.counts1[i];
+    }
+    node.evicted[rel_dir]++;
+  }
+  pair.head++;
+  if (pair.Len() == 0) {
+    pairs_.DelKey(key);
+    for (int side = 0; side < 2; side++) {
+      int node = (side == 0) ? key.Val1 : key.Val2;
+      NodeData& node_data = nodes_.GetDat(node);
+      node_data.nbrs.DelKey((side == 0) ? key.Val2 : key.Val1);
+      if (node_data.nbrs.Empty()) { nodes_.DelKey(node); }
+    }
+  } else if (pair.head > 64 && 2 * pair.head > pair.seqs.Len()) {
+    pair.seqs.Del(0, pair.head - 1);
+    pair.head = 0;
+  }
+  head_++;
+  if (head_ > 1024 && 2 * head_ > window_.Len()) {
+    window_.Del(0, head_ - 1);
+    head_ = 0;
+  }
+}
+
+void OnlineTempMotifCounter::CountTriads(int src, int dst) {
+  if (!nodes_.IsKey(src) || !nodes_.IsKey(dst)) { return; }
+  const TIntSet& src_nbrs = nodes_.GetDat(src).nbrs;
+  const TIntSet& dst_nbrs = nodes_.GetDat(dst).nbrs;
+  const TIntSet& nbrs = (src_nbrs.Len() <= dst_nbrs.Len()) ? src_nbrs : dst_nbrs;
+  const TIntSet& other_nbrs = (src_nbrs.Len() <= dst_nbrs.Len()) ? dst_nbrs : src_nbrs;
+  for (int k = nbrs.FFirstKeyId(); nbrs.FNextKeyId(k); ) {
+    int w = nbrs.GetKey(k);
+    if (w == src || w == dst || !other_nbrs.IsKey(w)) { continue; }
+    TIntPr src_key(MIN(src, w), MAX(src, w));
+    TIntPr dst_key(MIN(dst, w), MAX(dst, w));
+    const PairData& src_pair = pairs_.GetDat(src_key);
+    const PairData& dst_pair = pairs_.GetDat(dst_key);
+    // Merge the kept temporal edges on {src, w} and {dst, w} by arrival and
+    // count ordered pairs by which static edge comes first and the directions.
+    int64 seen_src[2] = {0, 0};
+    int64 seen_dst[2] = {0, 0};
+    int64 src_first[2][2] = {{0, 0}, {0, 0}};
+    int64 dst_first[2][2] = {{0, 0}, {0, 0}};
+    int i = src_pair.head;
+    int j = dst_pair.head;
+    while (i < src_pair.seqs.Len() || j < dst_pair.seqs.Len()) {
+      if (j == dst_pair.seqs.Len() ||
+          (i < src_pair.seqs.Len() && src_pair.seqs[i] < dst_pair.seqs[j])) {
+        int dir1 = int(src_pair.seqs[i] & 1);
+        for (int dir2 = 0; dir2 < 2; dir2++) { dst_first[dir2][dir1] += seen_dst[dir2]; }
+        seen_src[dir1]++;
+        i++;
+      } else {
+        int dir2 = int(dst_pair.seqs[j] & 1);
+        for (int dir1 = 0; dir1 < 2; dir1++) { src_first[dir1][dir2] += seen_src[dir1]; }
+        seen_dst[dir2]++;
+        j++;
+      }
+    }
+    for (int dir1 = 0; dir1 < 2; dir1++) {
+      for (int dir2 = 0; dir2 < 2; dir2++) {
+        int s1 = (dir1 == 0) ? src_key.Val1 : src_key.Val2;
+        int d1 = (dir1 == 0) ? src_key.Val2 : src_key.Val1;
+        int s2 = (dir2 == 0) ? dst_key.Val1 : dst_key.Val2;
+        int d2 = (dir2 == 0) ? dst_key.Val2 : dst_key.Val1;
+        if (src_first[dir1][dir2] > 0) {
+          AddTriad(s1, d1, s2, d2, src, dst, src_first[dir1][dir2]);
+        }
+        if (dst_first[dir2][dir1] > 0) {
+          AddTriad(s2, d2, s1, d1, src, dst, dst_first[dir2][dir1]);
+        }
+      }
+    }
+  }
+}
+
+void OnlineTempMotifCounter::AddTriad(int src1, int dst1, int src2, int dst2,
+                                      int src3, int dst3, int64 count) {
+  // With the first temporal edge i --> j, the second one is on {j, k} or
+  // {i, k} and the third one on the remaining static edge.  See
+  // TempMotifCounter::Count3TEdgeTriads() for the order of the counts.
+  int i = src1;
+  int j = dst1;
+  if (src2 == j || dst2 == j) {
+    triad_counts_(0, (src2 == j) ? 1 : 0, (src3 == i) ? 0 : 1) += count;
+  } else {
+    triad_counts_(1, (src2 == i) ? 1 : 0, (src3 == j) ? 0 : 1) += count;
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,6 +36,10 @@ class Counter2D {
   TUInt64& operator()(int i, int j) { return data_[i + j * m_]; }
   int m() { return m_; }
   int n() { return n_; }
+  // Adds the counts of other, which must have the same dimensions.
+  void Add(const Counter2D& other) {
+    for (int i = 0; i < data_.Len(); i++) { data_[i] += other.data_[i]; }
+  }
   
  private:
   int m_;
@@ -60,6 +64,10 @@ class Counter3D {
   int m() { return m_; }
   int n() { return n_; }
   int p() { return p_; }  
+  // Adds the counts of other, which must have the same dimensions.
+  void Add(const Counter3D& other) {
+    for (int i = 0; i < data_.Len(); i++) { data_[i] += other.data_[i]; }
+  }
   
  private:
   int m_;
@@ -172,12 +180,26 @@ class TempMotifCounter {
 
   // Checks whether or not there is a temporal edge along the static edge (u, v)
   bool HasEdges(int u, int v);
+  // Position of the static edge (u, v) in the temporal edge index or -1 if
+  // there is no such edge.
+  int GetEdgeIdx(int u, int v);
+  // Position of the static edge (min(u, v), max(u, v)) if it exists and of
+  // (max(u, v), min(u, v)) otherwise.  Identifies the undirected edge {u, v}.
+  int GetUndirEdgeIdx(int u, int v);
+  // Sets [beg, end) to the range of timestamps_ holding the (sorted) temporal
+  // edges along the static edge (u, v).  The range is empty if there are none.
+  void GetEventRange(int u, int v, int64& beg, int64& end);
+  // Number of temporal edges along the static edge (u, v)
+  int64 GetNumEvents(int u, int v);
+  // Number of per-thread counters to allocate and index of the calling thread
+  static int GetNumThreads();
+  static int GetThreadId();
 
   // A simple wrapper for adding triad edge data
-  void AddTriadEdgeData(TVec<TriadEdgeData>& events, TVec<TIntPair>& ts_indices,
+  void AddTriadEdgeData(TVec<TriadEdgeData>& events, TIntPrV& ts_indices,
                         int& index, int u, int v, int nbr, int key1, int key2);
   // A simple wrapper for adding star edge data  
-  void AddStarEdgeData(TVec<TIntPair>& ts_indices, TVec<StarEdgeData>& events,
+  void AddStarEdgeData(TIntPrV& ts_indices, TVec<StarEdgeData>& events,
 		       int& index, int u, int v, int nbr, int key);
   // Another simple wrapper for adding star edge data
   void AddStarEdges(TVec<TIntPair>& combined, int u, int v, int key);
@@ -185,9 +207,100 @@ class TempMotifCounter {
   // Directed graph from ignoring timestamps
   PNGraph static_graph_;  
 
-  // Core data structure for storing temporal edges.  temporal_data_[u](v) is a
-  // list of temporal edges along the static edge (u, v).
-  TVec< THash<TInt, TIntV> > temporal_data_;
+  // Core data structure for storing temporal edges, built once when the data is
+  // loaded.  The out-neighbors of node u are dst_[nbr_off_[u]], ...,
+  // dst_[nbr_off_[u + 1] - 1] in increasing order and the temporal edges along
+  // the static edge at position e of dst_ are the timestamps
+  // timestamps_[ts_off_[e]], ..., timestamps_[ts_off_[e + 1] - 1], sorted in
+  // increasing order.
+  TIntV nbr_off_;
+  TIntV dst_;
+  TInt64V ts_off_;
+  TVec<TInt, int64> timestamps_;
+};
+
+// Online version of TempMotifCounter::Count3TEdge23Node() for a stream of
+// temporal edges that arrive in time order.  Only the temporal edges of the last
+// delta time units are kept, so the state is bounded by the number of temporal
+// edges in a time window of length delta rather than by the length of the
+// stream.  A motif instance is counted when its last temporal edge is added and
+// the counts accumulate until ResetCounts(), so reporting the counts and then
+// resetting them at fixed times gives the counts per reporting window.  Each
+// addition takes time linear in the number of kept temporal edges on the
+// static edges of the triangles closed by the new edge.
+class OnlineTempMotifCounter {
+ public:
+  OnlineTempMotifCounter(double delta);
+
+  // Adds the temporal edge src --> dst at time timestamp and counts all motif
+  // instances ending with it.  Timestamps must be non-decreasing and self loops
+  // are ignored.
+  void AddEdge(int src, int dst, int timestamp);
+
+  // Gets the counts of motif instances completed since the last call to
+  // ResetCounts() such that counts(i, j) corresponds to motif M_{i,j}, the
+  // same format as TempMotifCounter::Count3TEdge23Node().
+  void GetCounts(Counter2D& counts);
+  // Resets the counts but keeps the temporal edges of the last delta time units
+  void ResetCounts();
+
+  // Number of temporal edges currently kept in the window
+  int GetWindowEdges() const { return window_.Len() - head_; }
+
+ private:
+  // State of a static (undirected) edge {a, b} with a < b.  Directions are 0
+  // for a --> b and 1 for b --> a, and sides are 0 for a and 1 for b, with
+  // the per-side counts using directions relative to that node (0: outgoing).
+  class PairData {
+   public:
+    PairData();
+    int64 Len() const { return counts1[0] + counts1[1]; }
+    int64 counts1[2];     // kept temporal edges by direction
+    int64 counts2[2][2];  // ordered pairs of kept temporal edges by directions
+    // Sums of the node arrival counts of the node on each side right after
+    // and right before each kept temporal edge, by direction of the temporal
+    // edge and direction of the counted arrivals.
+    int64 sum_after[2][2][2];
+    int64 sum_before[2][2][2];
+    // Kept temporal edges as 2 * sequence number + direction, from seqs[head]
+    TInt64V seqs;
+    int head;
+  };
+  // State of a node with kept temporal edges, directions relative to the node
+  class NodeData {
+   public:
+    NodeData();
+    int64 arrived[2];   // temporal edges added since the node was created
+    int64 evicted[2];   // temporal edges evicted since the node was created
+    int64 same[2][2];   // sum of PairData::counts2 over the node's static edges
+    TIntSet nbrs;       // nodes sharing a static edge with kept temporal edges
+  };
+  // A kept temporal edge
+  class WindowEdge {
+   public:
+    int src;
+    int dst;
+    int timestamp;
+    int64 after[2][2];  // arrival counts of both end points right after it
+  };
+
+  void PopEdge();
+  void CountTriads(int src, int dst);
+  void AddTriad(int src1, int dst1, int src2, int dst2, int src3, int dst3,
+                int64 count);
+
+  double delta_;
+  int last_timestamp_;
+  int64 next_seq_;
+  TVec<WindowEdge> window_;  // kept temporal edges, from window_[head_]
+  int head_;
+  THash<TIntPr, PairData> pairs_;
+  THash<TInt, NodeData> nodes_;
+  Counter2D edge_counts_;
+  Counter3D pre_counts_;
+  Counter3D pos_counts_;
+  Counter3D mid_counts_;
+  Counter3D triad_counts_;
 };
 
 // This class exhaustively counts all size^3 three-edge temporal motifs in an
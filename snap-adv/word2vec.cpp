@@ -53,65 +53,104 @@ void InitUnigramTable(TIntV& Vocab, TIntV& KTable, TFltV& UTable) {
   }
 }
 
-int64 RndUnigramInt(TIntV& KTable, TFltV& UTable, TRnd& Rnd) {
+int64 RndUnigramInt(const TIntV& KTable, const TFltV& UTable, TRnd& Rnd) {
   TInt X = KTable[static_cast<int64>(Rnd.GetUniDev()*KTable.Len())];
   double Y = Rnd.GetUniDev();
   return Y < UTable[X] ? X : KTable[X];
 }
 
-//Initialize negative embeddings
-void InitNegEmb(TIntV& Vocab, int& Dimensions, TVVec<TFlt, int64>& SynNeg) {
-  SynNeg = TVVec<TFlt, int64>(Vocab.Len(),Dimensions);
-  for (int64 i = 0; i < SynNeg.GetXDim(); i++) {
-    for (int j = 0; j < SynNeg.GetYDim(); j++) {
-      SynNeg(i,j) = 0;
-    }
+//Row-major float matrix, every row padded to EmbAlign floats and aligned
+class TEmbMtx {
+private:
+  char* Bf;
+  float* ValT;
+  int64 Rows;
+  int Cols, RowLen;
+  UndefCopyAssign(TEmbMtx);
+public:
+  TEmbMtx(const int64& _Rows, const int& _Cols) : Bf(NULL), ValT(NULL),
+   Rows(_Rows), Cols(_Cols), RowLen((_Cols + EmbAlign - 1) / EmbAlign * EmbAlign) {
+    const size_t AlignBytes = EmbAlign * sizeof(float);
+    const size_t Bytes = Rows * RowLen * sizeof(float) + AlignBytes;
+    Bf = (char*) malloc(Bytes);
+    EAssertR(Bf != NULL, "Out of memory for the embedding matrix");
+    memset(Bf, 0, Bytes);
+    ValT = (float*) (Bf + (AlignBytes - ((size_t) Bf) % AlignBytes) % AlignBytes);
   }
+  ~TEmbMtx() { free(Bf); }
+  int64 GetRows() const { return Rows; }
+  int GetCols() const { return Cols; }
+  /// Number of floats per row including padding, a multiple of EmbAlign
+  int GetRowLen() const { return RowLen; }
+  float* GetRow(const int64& Row) { return ValT + Row * RowLen; }
+  const float* GetRow(const int64& Row) const { return ValT + Row * RowLen; }
+};
+
+//Dot product of two embedding rows
+inline float EmbDot(const float* X, const float* Y, const int& Len) {
+  float Sum = 0;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd reduction(+:Sum)
+#endif
+  for (int i = 0; i < Len; i++) { Sum += X[i] * Y[i]; }
+  return Sum;
+}
+
+//Y += A*X for two embedding rows
+inline void EmbAxpy(const float A, const float* X, float* Y, const int& Len) {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+  for (int i = 0; i < Len; i++) { Y[i] += A * X[i]; }
 }
 
-//Initialize positive embeddings
-void InitPosEmb(TIntV& Vocab, int& Dimensions, TRnd& Rnd, TVVec<TFlt, int64>& SynPos) {
-  SynPos = TVVec<TFlt, int64>(Vocab.Len(),Dimensions);
-  for (int64 i = 0; i < SynPos.GetXDim(); i++) {
-    for (int j = 0; j < SynPos.GetYDim(); j++) {
-      SynPos(i,j) =(Rnd.GetUniDev()-0.5)/Dimensions;
+//Initialize positive embeddings, negative embeddings start at zero
+void InitPosEmb(const int& Dimensions, TRnd& Rnd, TEmbMtx& SynPos) {
+  for (int64 i = 0; i < SynPos.GetRows(); i++) {
+    float* RowT = SynPos.GetRow(i);
+    for (int j = 0; j < Dimensions; j++) {
+      RowT[j] = static_cast<float>((Rnd.GetUniDev()-0.5)/Dimensions);
     }
   }
 }
 
-void TrainModel(TVVec<TInt, int64>& WalksVV, int& Dimensions, int& WinSize, int& Iter, bool& Verbose,
-   TIntV& KTable, TFltV& UTable, int64& WordCntAll, TFltV& ExpTable, double& Alpha,
-   int64 CurrWalk, TRnd& Rnd, TVVec<TFlt, int64>& SynNeg, TVVec<TFlt, int64>& SynPos)  {
-  TFltV Neu1V(Dimensions);
-  TFltV Neu1eV(Dimensions);
-  int64 AllWords = WalksVV.GetXDim()*WalksVV.GetYDim();
-  TIntV WalkV(WalksVV.GetYDim());
-  for (int j = 0; j < WalksVV.GetYDim(); j++) { WalkV[j] = WalksVV(CurrWalk,j); }
-  for (int64 WordI=0; WordI<WalkV.Len(); WordI++) {
-    if ( WordCntAll%10000 == 0 ) {
-      if ( Verbose ) {
-        printf("\rLearning Progress: %.2lf%% ",(double)WordCntAll*100/(double)(Iter*AllWords));
-        fflush(stdout);
-      }
-      Alpha = StartAlpha * (1 - WordCntAll / static_cast<double>(Iter * AllWords + 1));
-      if ( Alpha < StartAlpha * 0.0001 ) { Alpha = StartAlpha * 0.0001; }
-    }
-    int64 Word = WalkV[WordI];
-    for (int i = 0; i < Dimensions; i++) {
-      Neu1V[i] = 0;
-      Neu1eV[i] = 0;
-    }
+//Precompute sigmoid on [-MaxExp, MaxExp]
+void InitSigmoidTable(TSFltV& SigmoidV) {
+  SigmoidV.Gen(TableSize + 1);
+  for (int i = 0; i <= TableSize; i++) {
+    double Value = -MaxExp + static_cast<double>(i) / static_cast<double>(ExpTablePrecision);
+    SigmoidV[i] = static_cast<float>(1.0 / (1.0 + TMath::Power(TMath::E, -Value)));
+  }
+}
+
+//Learning rate after WordCnt of AllWords words were processed
+double GetAlpha(const int64& WordCnt, const int64& AllWords) {
+  double Alpha = StartAlpha * (1 - WordCnt / static_cast<double>(AllWords + 1));
+  return Alpha < StartAlpha * 0.0001 ? StartAlpha * 0.0001 : Alpha;
+}
+
+//Train on a single walk. Threads update SynPos and SynNeg without locking (Hogwild).
+//Returns the number of words processed.
+int64 TrainModel(const TVVec<TInt, int64>& WalksVV, const int64& CurrWalk, const int& WinSize,
+   const TIntV& KTable, const TFltV& UTable, const TSFltV& SigmoidV, const double& Alpha,
+   TRnd& Rnd, float* Neu1eT, TEmbMtx& SynNeg, TEmbMtx& SynPos) {
+  const int RowLen = SynPos.GetRowLen();
+  const int64 WalkLen = WalksVV.GetYDim();
+  const float FAlpha = static_cast<float>(Alpha);
+  for (int64 WordI = 0; WordI < WalkLen; WordI++) {
+    const int64 Word = WalksVV(CurrWalk, WordI);
     int Offset = Rnd.GetUniDevInt() % WinSize;
     for (int a = Offset; a < WinSize * 2 + 1 - Offset; a++) {
       if (a == WinSize) { continue; }
       int64 CurrWordI = WordI - WinSize + a;
       if (CurrWordI < 0){ continue; }
-      if (CurrWordI >= WalkV.Len()){ continue; }
-      int64 CurrWord = WalkV[CurrWordI];
-      for (int i = 0; i < Dimensions; i++) { Neu1eV[i] = 0; }
+      if (CurrWordI >= WalkLen){ continue; }
+      float* PosT = SynPos.GetRow(WalksVV(CurrWalk, CurrWordI));
+      memset(Neu1eT, 0, RowLen * sizeof(float));
       //negative sampling
       for (int j = 0; j < NegSamN+1; j++) {
-        int64 Target, Label;
+        int64 Target;
+        float Label;
         if (j == 0) {
           Target = Word;
           Label = 1;
@@ -120,79 +159,168 @@ void TrainModel(TVVec<TInt, int64>& WalksVV, int& Dimensions, int& WinSize, int&
           if (Target == Word) { continue; }
           Label = 0;
         }
-        double Product = 0;
-        for (int i = 0; i < Dimensions; i++) {
-          Product += SynPos(CurrWord,i) * SynNeg(Target,i);
-        }
-        double Grad;                     //Gradient multiplied by learning rate
-        if (Product > MaxExp) { Grad = (Label - 1) * Alpha; }
-        else if (Product < -MaxExp) { Grad = Label * Alpha; }
-        else { 
-          double Exp = ExpTable[static_cast<int>(Product*ExpTablePrecision)+TableSize/2];
-          Grad = (Label - 1 + 1 / (1 + Exp)) * Alpha;
+        float* NegT = SynNeg.GetRow(Target);
+        const float Product = EmbDot(PosT, NegT, RowLen);
+        float Grad;                     //Gradient multiplied by learning rate
+        if (Product > MaxExp) { Grad = (Label - 1) * FAlpha; }
+        else if (Product < -MaxExp) { Grad = Label * FAlpha; }
+        else {
+          Grad = (Label - SigmoidV[static_cast<int>((Product + MaxExp) * ExpTablePrecision)]) * FAlpha;
         }
-        for (int i = 0; i < Dimensions; i++) { 
-          Neu1eV[i] += Grad * SynNeg(Target,i);
-          SynNeg(Target,i) += Grad * SynPos(CurrWord,i);
-        }
-      }
-      for (int i = 0; i < Dimensions; i++) {
-        SynPos(CurrWord,i) += Neu1eV[i];
+        EmbAxpy(Grad, NegT, Neu1eT, RowLen);
+        EmbAxpy(Grad, PosT, NegT, RowLen);
       }
+      EmbAxpy(1, Neu1eT, PosT, RowLen);
     }
-    WordCntAll++;
   }
+  return WalkLen;
 }
 
 
+//Skip-gram model shared by all training threads
+class TSkipGram {
+private:
+  TIntV KTable;
+  TFltV UTable;
+  TSFltV SigmoidV;
+  TEmbMtx SynNeg, SynPos;
+  TVec<TRnd> RndV;
+  TEmbMtx Neu1eM;
+  int WinSize;
+  bool Verbose;
+  int64 AllWords, WordCntAll;
+  uint64 StartMSecs;
+  UndefCopyAssign(TSkipGram);
+  static int GetThreads() {
+#ifdef USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+  double GetSecs() const {
+    return TMath::Mx(TTm::GetCurUniMSecs() - StartMSecs, (uint64) 1) / 1000.0;
+  }
+public:
+  /// Vocab holds the frequency of every node, AllWords the number of words over all iterations
+  TSkipGram(TIntV& Vocab, const int& Dimensions, const int& _WinSize,
+   const int64& _AllWords, const bool& _Verbose) : KTable(Vocab.Len()), UTable(Vocab.Len()),
+   SynNeg(Vocab.Len(), Dimensions), SynPos(Vocab.Len(), Dimensions),
+   RndV(GetThreads()), Neu1eM(GetThreads(), Dimensions), WinSize(_WinSize),
+   Verbose(_Verbose), AllWords(_AllWords), WordCntAll(0) {
+    TRnd Rnd(time(NULL));
+    InitPosEmb(Dimensions, Rnd, SynPos);
+    InitUnigramTable(Vocab, KTable, UTable);
+    InitSigmoidTable(SigmoidV);
+    //every thread draws from its own generator and has its own gradient buffer
+    for (int t = 0; t < RndV.Len(); t++) {
+      RndV[t].PutSeed(Rnd.GetUniDevInt(1, TInt::Mx-1));
+    }
+    StartMSecs = TTm::GetCurUniMSecs();
+  }
+  /// Trains on all walks in WalksVV, walks are processed in parallel
+  void TrainBatch(const TVVec<TInt, int64>& WalksVV) {
+#pragma omp parallel for schedule(dynamic)
+    for (int64 i = 0; i < WalksVV.GetXDim(); i++) {
+      int ThreadN = 0;
+#ifdef USE_OPENMP
+      ThreadN = omp_get_thread_num();
+#endif
+      //the learning rate decays linearly with the words done by all threads
+      const double Alpha = GetAlpha(WordCntAll, AllWords);
+      const int64 WordCnt = TrainModel(WalksVV, i, WinSize, KTable, UTable, SigmoidV,
+       Alpha, RndV[ThreadN], Neu1eM.GetRow(ThreadN), SynNeg, SynPos);
+      int64 PrevWordCnt;
+#pragma omp critical
+      {
+        PrevWordCnt = WordCntAll;
+        WordCntAll += WordCnt;
+      }
+      if ( Verbose && PrevWordCnt/100000 != (PrevWordCnt+WordCnt)/100000 ) {
+        printf("\rLearning Progress: %.2lf%%, Alpha: %.6f, Words/sec: %.0f ",
+         (double)(PrevWordCnt+WordCnt)*100/(double)AllWords, Alpha,
+         (double)(PrevWordCnt+WordCnt)/GetSecs());
+        fflush(stdout);
+      }
+    }
+  }
+  /// Adds the embedding of node i under id NIdV[i]
+  void GetEmbeddings(const TIntV& NIdV, TIntFltVH& EmbeddingsHV) const {
+    if (Verbose) {
+      printf("\rLearning Progress: 100.00%%, Words/sec: %.0f, Time: %.2fs\n",
+       (double)WordCntAll/GetSecs(), GetSecs());
+      fflush(stdout);
+    }
+    for (int64 i = 0; i < SynPos.GetRows(); i++) {
+      const float* RowT = SynPos.GetRow(i);
+      TFltV CurrV(SynPos.GetCols());
+      for (int j = 0; j < SynPos.GetCols(); j++) { CurrV[j] = RowT[j]; }
+      EmbeddingsHV.AddDat(NIdV[i], CurrV);
+    }
+  }
+};
+
 void LearnEmbeddings(TVVec<TInt, int64>& WalksVV, int& Dimensions, int& WinSize,
  int& Iter, bool& Verbose, TIntFltVH& EmbeddingsHV) {
   TIntIntH RnmH;
-  TIntIntH RnmBackH;
-  int64 NNodes = 0;
+  TIntV RnmBackV;
   //renaming nodes into consecutive numbers
-  for (int i = 0; i < WalksVV.GetXDim(); i++) {
+  for (int64 i = 0; i < WalksVV.GetXDim(); i++) {
     for (int64 j = 0; j < WalksVV.GetYDim(); j++) {
       if ( RnmH.IsKey(WalksVV(i, j)) ) {
         WalksVV(i, j) = RnmH.GetDat(WalksVV(i, j));
       } else {
-        RnmH.AddDat(WalksVV(i,j),NNodes);
-        RnmBackH.AddDat(NNodes,WalksVV(i, j));
-        WalksVV(i, j) = NNodes++;
+        RnmH.AddDat(WalksVV(i,j),RnmBackV.Len());
+        WalksVV(i, j) = RnmBackV.Add(WalksVV(i, j));
       }
     }
   }
-  TIntV Vocab(NNodes);
+  TIntV Vocab(RnmBackV.Len());
   LearnVocab(WalksVV, Vocab);
-  TIntV KTable(NNodes);
-  TFltV UTable(NNodes);
-  TVVec<TFlt, int64> SynNeg;
-  TVVec<TFlt, int64> SynPos;
-  TRnd Rnd(time(NULL));
-  InitPosEmb(Vocab, Dimensions, Rnd, SynPos);
-  InitNegEmb(Vocab, Dimensions, SynNeg);
-  InitUnigramTable(Vocab, KTable, UTable);
-  TFltV ExpTable(TableSize);
-  double Alpha = StartAlpha;                              //learning rate
-#pragma omp parallel for schedule(dynamic)
-  for (int i = 0; i < TableSize; i++ ) {
-    double Value = -MaxExp + static_cast<double>(i) / static_cast<double>(ExpTablePrecision);
-    ExpTable[i] = TMath::Power(TMath::E, Value);
-  }
-  int64 WordCntAll = 0;
+  TSkipGram Model(Vocab, Dimensions, WinSize,
+   Iter * WalksVV.GetXDim() * WalksVV.GetYDim(), Verbose);
 // op RS 2016/09/26, collapse does not compile on Mac OS X
 //#pragma omp parallel for schedule(dynamic) collapse(2)
   for (int j = 0; j < Iter; j++) {
-#pragma omp parallel for schedule(dynamic)
-    for (int64 i = 0; i < WalksVV.GetXDim(); i++) {
-      TrainModel(WalksVV, Dimensions, WinSize, Iter, Verbose, KTable, UTable,
-       WordCntAll, ExpTable, Alpha, i, Rnd, SynNeg, SynPos); 
-    }
+    Model.TrainBatch(WalksVV);
   }
-  if (Verbose) { printf("\n"); fflush(stdout); }
-  for (int64 i = 0; i < SynPos.GetXDim(); i++) {
-    TFltV CurrV(SynPos.GetYDim());
-    for (int j = 0; j < SynPos.GetYDim(); j++) { CurrV[j] = SynPos(i, j); }
-    EmbeddingsHV.AddDat(RnmBackH.GetDat(i), CurrV);
+  Model.GetEmbeddings(RnmBackV, EmbeddingsHV);
+}
+
+void LearnEmbeddings(const TStr& WalkFNm, const TIntV& NIdV, TIntV& Vocab,
+ const int64& BatchWalks, int& Dimensions, int& WinSize, int& Iter, bool& Verbose,
+ TIntFltVH& EmbeddingsHV) {
+  int64 AllWalks;
+  int WalkLen;
+  {
+    TFIn FIn(WalkFNm);
+    FIn.Load(AllWalks);
+    FIn.Load(WalkLen);
   }
+  TSkipGram Model(Vocab, Dimensions, WinSize, Iter * AllWalks * WalkLen, Verbose);
+  TVVec<TInt, int64> WalksVV;
+  for (int j = 0; j < Iter; j++) {
+    //every iteration reads the walk file sequentially, one batch at a time
+    TFIn FIn(WalkFNm);
+    FIn.Load(AllWalks);
+    FIn.Load(WalkLen);
+    for (int64 Walk = 0; Walk < AllWalks; Walk += BatchWalks) {
+      const int64 Walks = TMath::Mn(BatchWalks, AllWalks - Walk);
+      if (WalksVV.GetXDim() != Walks) { WalksVV.Gen(Walks, WalkLen); }
+      LoadWalkBatch(FIn, WalksVV);
+      Model.TrainBatch(WalksVV);
+    }
+  }
+  Model.GetEmbeddings(NIdV, EmbeddingsHV);
+}
+
+void SaveWalkBatch(TSOut& SOut, const TVVec<TInt, int64>& WalksVV) {
+  if (WalksVV.Empty()) { return; }
+  //rows of TVVec are stored contiguously
+  SOut.PutBf(&WalksVV(0, 0).Val, WalksVV.GetXDim() * WalksVV.GetYDim() * sizeof(int));
+}
+
+void LoadWalkBatch(TSIn& SIn, TVVec<TInt, int64>& WalksVV) {
+  if (WalksVV.Empty()) { return; }
+  SIn.GetBf(&WalksVV(0, 0).Val, WalksVV.GetXDim() * WalksVV.GetYDim() * sizeof(int));
 }
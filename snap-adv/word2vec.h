@@ -2,9 +2,23 @@
 #define WORD_2_VEC_H
 
 ///Learns embeddings using SGD, Skip-gram with negative sampling.
+///Threads train on different walks and update the shared float embeddings without locking.
 void LearnEmbeddings(TVVec<TInt, int64>& WalksVV, int& Dimensions, int& WinSize,
  int& Iter, bool& Verbose, TIntFltVH& EmbeddingsHV);
 
+///Learns embeddings from a walk file, reading it sequentially in batches of BatchWalks walks per iteration.
+///The file holds the number of walks (int64), the walk length (int) and the walks, see SaveWalkBatch.
+///Walks consist of node indices, NIdV maps them back to node ids and Vocab holds their frequencies.
+void LearnEmbeddings(const TStr& WalkFNm, const TIntV& NIdV, TIntV& Vocab,
+ const int64& BatchWalks, int& Dimensions, int& WinSize, int& Iter, bool& Verbose,
+ TIntFltVH& EmbeddingsHV);
+
+///Appends the walks in WalksVV to a walk file as raw ints, one walk after another
+void SaveWalkBatch(TSOut& SOut, const TVVec<TInt, int64>& WalksVV);
+
+///Reads the next WalksVV.GetXDim() walks from a walk file into WalksVV
+void LoadWalkBatch(TSIn& SIn, TVVec<TInt, int64>& WalksVV);
+
 //Max x for e^x. Value taken from original word2vec code.
 const int MaxExp = 6;
 
@@ -15,6 +29,12 @@ const int TableSize = MaxExp*ExpTablePrecision*2;
 //Number of negative samples. Value taken from original word2vec code.
 const int NegSamN = 5;
 
+//Embedding rows are padded and aligned to this many floats (64 bytes) for SIMD.
+const int EmbAlign = 16;
+
+//Number of walks held in memory at a time when walks are streamed through a file.
+const int64 WalkBatchN = 65536;
+
 //Learning rate for SGD. Value taken from original word2vec code.
 const double StartAlpha = 0.025;
 
@@ -19,6 +19,8 @@
 #include "networkmp.cpp"     // networks OMP
 //#include "timenet.cpp"       // time evolving networks              TODO 64
 #include "mmnet.cpp"         // multimodal networks
+#include "mmapnet.cpp"       // memory-mapped graph snapshots
+#include "compgraph.cpp"     // compressed graphs
 
 // algorithms
 #include "subgraph.cpp"      // subgraph manipulations
@@ -22,9 +22,12 @@
 #include "bignet.h"          // large networks
 //#include "timenet.h"         // time evolving networks             TODO 64
 #include "mmnet.h"           // multimodal networks
+#include "mmapnet.h"         // memory-mapped graph snapshots
+#include "compgraph.h"       // compressed graphs
 
 // algorithms
 #include "subgraph.h"        // subgraph manipulations
+#include "reorder.h"         // node reordering
 #include "anf.h"             // approximate diameter calculation
 //#include "bfsdfs.h"          // breadth and depth first search      TODO 64
 #include "cncom.h"           // connected components
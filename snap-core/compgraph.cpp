@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////
+// Compressed graph
+void TCompGraph::AddList(const int64& NIdx, const TInt64V& NbrV, TByteV& BfV) const {
+  const int64 Deg = NbrV.Len();
+  PutVarInt(Deg, BfV);
+  if (Deg == 0) { return; }
+  TInt64V IntV, ResV;
+  if (MnIntervalLen > 0) {
+    // maximal runs of consecutive indices become intervals, the rest are residuals
+    for (int64 Beg = 0; Beg < Deg; ) {
+      int64 End = Beg+1;
+      while (End < Deg && NbrV[End] == NbrV[End-1]+1) { End++; }
+      if (End-Beg >= MnIntervalLen) {
+        IntV.Add(NbrV[Beg]);  IntV.Add(End-Beg);
+      } else {
+        for (int64 i = Beg; i < End; i++) { ResV.Add(NbrV[i]); }
+      }
+      Beg = End;
+    }
+    PutVarInt(IntV.Len()/2, BfV);
+    for (int64 i = 0; i < IntV.Len(); i += 2) {
+      // intervals are separated by at least one missing index
+      if (i == 0) { PutVarInt(ZigZag(IntV[i]-NIdx), BfV); }
+      else { PutVarInt(IntV[i]-(IntV[i-2]+IntV[i-1])-1, BfV); }
+      PutVarInt(IntV[i+1]-MnIntervalLen, BfV);
+    }
+  }
+  const TInt64V& GapV = MnIntervalLen > 0 ? ResV : NbrV;
+  for (int64 i = 0; i < GapV.Len(); i++) {
+    if (i == 0) { PutVarInt(ZigZag(GapV[i]-NIdx), BfV); }
+    else { PutVarInt(GapV[i]-GapV[i-1]-1, BfV); }
+  }
+}
+
+void TCompGraph::GetList(const int64& NIdx, const uchar* Pt, TInt64V& NbrV) const {
+  const int64 Deg = (int64) GetVarInt(Pt);
+  NbrV.Reserve(Deg, Deg);
+  if (Deg == 0) { return; }
+  TInt64V IntV;
+  int64 IntVals = 0;
+  if (MnIntervalLen > 0) {
+    const int64 Intervals = (int64) GetVarInt(Pt);
+    IntV.Gen(2*Intervals);
+    for (int64 i = 0; i < 2*Intervals; i += 2) {
+      if (i == 0) { IntV[i] = NIdx+UnZigZag(GetVarInt(Pt)); }
+      else { IntV[i] = IntV[i-2]+IntV[i-1]+1+(int64) GetVarInt(Pt); }
+      IntV[i+1] = MnIntervalLen+(int64) GetVarInt(Pt);
+      IntVals += IntV[i+1];
+    }
+  }
+  // residuals go to the front of NbrV
+  const int64 Res = Deg-IntVals;
+  for (int64 i = 0; i < Res; i++) {
+    if (i == 0) { NbrV[i] = NIdx+UnZigZag(GetVarInt(Pt)); }
+    else { NbrV[i] = NbrV[i-1]+1+(int64) GetVarInt(Pt); }
+  }
+  if (IntVals == 0) { return; }
+  // merge residuals and intervals from the back, in place
+  int64 ResN = Res-1, IntN = IntV.Len()-2, IntVal = IntV.Empty() ? 0 : IntV[IntN]+IntV[IntN+1]-1;
+  for (int64 Pos = Deg-1; Pos >= 0; Pos--) {
+    if (IntN >= 0 && (ResN < 0 || IntVal > NbrV[ResN])) {
+      NbrV[Pos] = IntVal;
+      if (IntVal == IntV[IntN]) {
+        IntN -= 2;
+        if (IntN >= 0) { IntVal = IntV[IntN]+IntV[IntN+1]-1; }
+      } else { IntVal--; }
+    } else {
+      NbrV[Pos] = NbrV[ResN--];
+    }
+  }
+}
+
+bool TCompGraph::IsEdge(const int64& SrcNId, const int64& DstNId) const {
+  const int64 SrcNIdx = GetNIdx(SrcNId), DstNIdx = GetNIdx(DstNId);
+  if (SrcNIdx == -1 || DstNIdx == -1) { return false; }
+  TInt64V NbrV;
+  GetOutNIdxV(SrcNIdx, NbrV);
+  return NbrV.SearchBin(DstNIdx) != -1;
+}
+
+void TCompGraph::TEdgeI::SkipEdges() {
+  while (CurNode < EndNode) {
+    if (CurEdge >= CurNode.GetOutDeg()) { CurNode++; CurEdge = 0; continue; }
+    // undirected edges are stored in both lists, visit only the copy with Src<=Dst
+    if (! CurNode.Graph->IsDirected() && CurNode.GetOutNIdxV()[CurEdge] < CurNode.NIdx) { CurEdge++; continue; }
+    break;
+  }
+}
+
+PCompGraph TCompGraph::LoadShM(TShMIn& ShMIn) {
+  TCompGraph* Graph = new TCompGraph();
+  Graph->Directed = TBool(ShMIn);
+  Graph->MnIntervalLen = TInt(ShMIn);
+  Graph->Edges = TInt64(ShMIn);
+  Graph->NIdV.LoadShM(ShMIn);
+  Graph->OutOffV.LoadShM(ShMIn);
+  Graph->InOffV.LoadShM(ShMIn);
+  Graph->OutBfV.LoadShM(ShMIn);
+  Graph->InBfV.LoadShM(ShMIn);
+  return PCompGraph(Graph);
+}
+
+void TCompGraph::Save(TSOut& SOut) const {
+  Directed.Save(SOut);  MnIntervalLen.Save(SOut);  Edges.Save(SOut);
+  NIdV.Save(SOut);  OutOffV.Save(SOut);  InOffV.Save(SOut);
+  OutBfV.Save(SOut);  InBfV.Save(SOut);
+}
@@ -0,0 +1,220 @@
+//#//////////////////////////////////////////////
+/// Compressed read-only graph.
+class TCompGraph;
+/// Pointer to a compressed graph (TCompGraph).
+typedef TPt<TCompGraph> PCompGraph;
+
+/// Read-only directed or undirected graph with compressed neighbor lists.
+/// Nodes are stored as a sorted vector of ids; a node's neighbors are stored as
+/// node indices (positions in that vector) in one byte stream per direction.
+/// Each list is the degree followed by WebGraph-style gap codes: the first
+/// neighbor relative to the node itself, every following one relative to its
+/// predecessor, all written as variable-length integers (7 bits per byte).
+/// If MnIntervalLen>0, runs of at least MnIntervalLen consecutive indices are
+/// stored as (start, length) intervals and only the remaining neighbors are gap
+/// coded. Per-node byte offsets give random access to any list; decoding a
+/// list is a single sequential pass. Parallel edges are collapsed.
+class TCompGraph {
+public:
+  typedef TCompGraph TNet;
+  typedef TPt<TCompGraph> PNet;
+  typedef TVec<TUCh, int64> TByteV;
+  class TEdgeI;
+public:
+  /// Node iterator. Nodes are visited in increasing order of their ids.
+  /// Neighbor lists are decoded on first access and cached in the iterator.
+  class TNodeI {
+  private:
+    const TCompGraph* Graph;
+    int64 NIdx;
+    mutable TInt64V OutNIdxV, InNIdxV;
+    mutable bool OutDecoded, InDecoded;
+  public:
+    TNodeI() : Graph(NULL), NIdx(0), OutNIdxV(), InNIdxV(), OutDecoded(false), InDecoded(false) { }
+    TNodeI(const int64& NodeIdx, const TCompGraph* GraphPt) : Graph(GraphPt), NIdx(NodeIdx), OutNIdxV(), InNIdxV(), OutDecoded(false), InDecoded(false) { }
+    TNodeI(const TNodeI& NodeI) : Graph(NodeI.Graph), NIdx(NodeI.NIdx), OutNIdxV(), InNIdxV(), OutDecoded(false), InDecoded(false) { }
+    TNodeI& operator = (const TNodeI& NodeI) { Graph=NodeI.Graph; NIdx=NodeI.NIdx; OutDecoded=false; InDecoded=false; return *this; }
+    /// Increment iterator.
+    TNodeI& operator++ (int) { NIdx++; OutDecoded=false; InDecoded=false; return *this; }
+    bool operator < (const TNodeI& NodeI) const { return NIdx < NodeI.NIdx; }
+    bool operator == (const TNodeI& NodeI) const { return NIdx == NodeI.NIdx; }
+    /// Returns ID of the current node.
+    int64 GetId() const { return Graph->NIdV[NIdx]; }
+    /// Returns index of the current node.
+    int64 GetIdx() const { return NIdx; }
+    /// Returns degree of the current node, the sum of in-degree and out-degree.
+    int64 GetDeg() const { return Graph->IsDirected() ? GetInDeg()+GetOutDeg() : GetOutDeg(); }
+    /// Returns in-degree of the current node.
+    int64 GetInDeg() const { return Graph->GetInDeg(NIdx); }
+    /// Returns out-degree of the current node.
+    int64 GetOutDeg() const { return Graph->GetOutDeg(NIdx); }
+    /// Returns the sorted out-neighbor indices of the current node.
+    const TInt64V& GetOutNIdxV() const { if (! OutDecoded) { Graph->GetOutNIdxV(NIdx, OutNIdxV); OutDecoded=true; } return OutNIdxV; }
+    /// Returns the sorted in-neighbor indices of the current node.
+    const TInt64V& GetInNIdxV() const { if (! InDecoded) { Graph->GetInNIdxV(NIdx, InNIdxV); InDecoded=true; } return InNIdxV; }
+    /// Returns ID of EdgeN-th in-node (the node pointing to the current node).
+    int64 GetInNId(const int64& EdgeN) const { return Graph->NIdV[GetInNIdxV()[EdgeN]]; }
+    /// Returns ID of EdgeN-th out-node (the node the current node points to).
+    int64 GetOutNId(const int64& EdgeN) const { return Graph->NIdV[GetOutNIdxV()[EdgeN]]; }
+    /// Returns ID of EdgeN-th neighboring node.
+    int64 GetNbrNId(const int64& EdgeN) const { return EdgeN<GetOutDeg() ? GetOutNId(EdgeN) : GetInNId(EdgeN-GetOutDeg()); }
+    /// Tests whether node with ID NId points to the current node.
+    bool IsInNId(const int64& NId) const { const int64 Idx=Graph->GetNIdx(NId); return Idx!=-1 && GetInNIdxV().SearchBin(Idx)!=-1; }
+    /// Tests whether the current node points to node with ID NId.
+    bool IsOutNId(const int64& NId) const { const int64 Idx=Graph->GetNIdx(NId); return Idx!=-1 && GetOutNIdxV().SearchBin(Idx)!=-1; }
+    /// Tests whether node with ID NId is a neighbor of the current node.
+    bool IsNbrNId(const int64& NId) const { return IsOutNId(NId) || IsInNId(NId); }
+    friend class TCompGraph;
+    friend class TEdgeI;
+  };
+  /// Edge iterator. For undirected graphs each edge is visited once, with SrcNId<=DstNId.
+  class TEdgeI {
+  private:
+    TNodeI CurNode, EndNode;
+    int64 CurEdge;
+  public:
+    TEdgeI() : CurNode(), EndNode(), CurEdge(0) { }
+    TEdgeI(const TNodeI& NodeI, const TNodeI& EndNodeI, const int64& EdgeN=0) : CurNode(NodeI), EndNode(EndNodeI), CurEdge(EdgeN) { }
+    TEdgeI(const TEdgeI& EdgeI) : CurNode(EdgeI.CurNode), EndNode(EdgeI.EndNode), CurEdge(EdgeI.CurEdge) { }
+    TEdgeI& operator = (const TEdgeI& EdgeI) { if (this!=&EdgeI) { CurNode=EdgeI.CurNode; EndNode=EdgeI.EndNode; CurEdge=EdgeI.CurEdge; } return *this; }
+    /// Increment iterator.
+    TEdgeI& operator++ (int) { CurEdge++; SkipEdges(); return *this; }
+    bool operator < (const TEdgeI& EdgeI) const { return CurNode<EdgeI.CurNode || (CurNode==EdgeI.CurNode && CurEdge<EdgeI.CurEdge); }
+    bool operator == (const TEdgeI& EdgeI) const { return CurNode == EdgeI.CurNode && CurEdge == EdgeI.CurEdge; }
+    /// Returns edge ID. Always returns -1 since only edges in multigraphs have explicit IDs.
+    int64 GetId() const { return -1; }
+    /// Returns the source node of the edge.
+    int64 GetSrcNId() const { return CurNode.GetId(); }
+    /// Returns the destination node of the edge.
+    int64 GetDstNId() const { return CurNode.GetOutNId(CurEdge); }
+    /// Moves to the next edge that should be visited, skipping nodes without (remaining) edges.
+    void SkipEdges();
+    friend class TCompGraph;
+  };
+private:
+  TCRef CRef;
+  TBool Directed;
+  TInt MnIntervalLen;
+  TInt64 Edges;
+  TInt64V NIdV, OutOffV, InOffV;
+  TByteV OutBfV, InBfV;
+private:
+  TCompGraph() : CRef(), Directed(false), MnIntervalLen(0), Edges(0) { }
+  TCompGraph(const bool& IsDir, const int& MnIntervalLength) : CRef(), Directed(IsDir), MnIntervalLen(MnIntervalLength), Edges(0) { }
+  TCompGraph(TSIn& SIn) : CRef(), Directed(SIn), MnIntervalLen(SIn), Edges(SIn), NIdV(SIn), OutOffV(SIn), InOffV(SIn), OutBfV(SIn), InBfV(SIn) { }
+  UndefCopyAssign(TCompGraph);
+private:
+  /// Appends the compressed list of sorted, distinct node indices NbrV of node NIdx to BfV.
+  void AddList(const int64& NIdx, const TInt64V& NbrV, TByteV& BfV) const;
+  /// Decodes the list of node NIdx starting at byte Pt.
+  void GetList(const int64& NIdx, const uchar* Pt, TInt64V& NbrV) const;
+  static void PutVarInt(uint64 Val, TByteV& BfV) {
+    while (Val >= 0x80) { BfV.Add(TUCh(uchar(Val | 0x80))); Val >>= 7; }
+    BfV.Add(TUCh(uchar(Val)));
+  }
+  static uint64 GetVarInt(const uchar*& Pt) {
+    uint64 Val = 0;  int Shift = 0;
+    while (*Pt & 0x80) { Val |= uint64(*Pt & 0x7f) << Shift;  Shift += 7;  Pt++; }
+    Val |= uint64(*Pt) << Shift;  Pt++;
+    return Val;
+  }
+  /// Maps a signed value to an unsigned one with small absolute values staying small.
+  static uint64 ZigZag(const int64& Val) { return Val >= 0 ? uint64(Val) << 1 : (uint64(-(Val+1)) << 1) | 1; }
+  static int64 UnZigZag(const uint64& Val) { return (Val & 1) ? -int64(Val >> 1) - 1 : int64(Val >> 1); }
+  const uchar* GetOutPt(const int64& NIdx) const { return (const uchar*) (OutBfV.BegI()+OutOffV[NIdx]); }
+  const uchar* GetInPt(const int64& NIdx) const { return IsDirected() ? (const uchar*) (InBfV.BegI()+InOffV[NIdx]) : GetOutPt(NIdx); }
+public:
+  /// Builds a compressed graph from Graph, e.g., a PUNGraph, PNGraph or TBigNet.
+  template <class PGraph> static PCompGraph New(const PGraph& Graph, const int& MnIntervalLength=4);
+  /// Static constructor that loads the graph from a stream SIn and returns a pointer to it.
+  static PCompGraph Load(TSIn& SIn) { return PCompGraph(new TCompGraph(SIn)); }
+  /// Static constructor that loads the graph from shared memory without copying the node and edge arrays.
+  static PCompGraph LoadShM(TShMIn& ShMIn);
+  /// Saves the graph to a (binary) stream SOut.
+  void Save(TSOut& SOut) const;
+
+  /// Tests whether the graph is directed.
+  bool IsDirected() const { return Directed; }
+  /// Returns the number of nodes in the graph.
+  int64 GetNodes() const { return NIdV.Len(); }
+  /// Returns the number of edges in the graph.
+  int64 GetEdges() const { return Edges; }
+  /// Returns an id that is larger than any node id in the graph.
+  int64 GetMxNId() const { return NIdV.Empty() ? 0 : NIdV.Last()+1; }
+  /// Returns the index of node NId, or -1 if the node does not exist.
+  int64 GetNIdx(const int64& NId) const { return NIdV.SearchBin(NId); }
+  /// Returns the ID of the node at index NIdx.
+  int64 GetNId(const int64& NIdx) const { return NIdV[NIdx]; }
+  /// Tests whether ID NId is a node.
+  bool IsNode(const int64& NId) const { return GetNIdx(NId) != -1; }
+  /// Tests whether an edge from node IDs SrcNId to DstNId exists.
+  bool IsEdge(const int64& SrcNId, const int64& DstNId) const;
+  /// Returns the out-degree of the node at index NIdx.
+  int64 GetOutDeg(const int64& NIdx) const { const uchar* Pt = GetOutPt(NIdx); return (int64) GetVarInt(Pt); }
+  /// Returns the in-degree of the node at index NIdx.
+  int64 GetInDeg(const int64& NIdx) const { const uchar* Pt = GetInPt(NIdx); return (int64) GetVarInt(Pt); }
+  /// Decodes the sorted out-neighbor indices of the node at index NIdx.
+  void GetOutNIdxV(const int64& NIdx, TInt64V& NbrV) const { GetList(NIdx, GetOutPt(NIdx), NbrV); }
+  /// Decodes the sorted in-neighbor indices of the node at index NIdx.
+  void GetInNIdxV(const int64& NIdx, TInt64V& NbrV) const { GetList(NIdx, GetInPt(NIdx), NbrV); }
+  /// Returns an iterator referring to the first node in the graph.
+  TNodeI BegNI() const { return TNodeI(0, this); }
+  /// Returns an iterator referring to the past-the-end node in the graph.
+  TNodeI EndNI() const { return TNodeI(GetNodes(), this); }
+  /// Returns an iterator referring to the node of ID NId in the graph.
+  TNodeI GetNI(const int64& NId) const { return TNodeI(GetNIdx(NId), this); }
+  /// Returns an iterator referring to the first edge in the graph.
+  TEdgeI BegEI() const { TEdgeI EI(BegNI(), EndNI()); EI.SkipEdges(); return EI; }
+  /// Returns an iterator referring to the past-the-end edge in the graph.
+  TEdgeI EndEI() const { return TEdgeI(EndNI(), EndNI()); }
+  /// Returns the number of bytes used by the compressed neighbor lists.
+  int64 GetEdgeBytes() const { return OutBfV.Len() + InBfV.Len(); }
+  /// Returns the approximate number of bytes used by the graph.
+  int64 GetMemUsed() const { return sizeof(TCompGraph) + (NIdV.Len()+OutOffV.Len()+InOffV.Len())*sizeof(TInt64) + GetEdgeBytes(); }
+
+  friend class TPt<TCompGraph>;
+};
+
+// set flags
+namespace TSnap {
+template <> struct IsDirected<TCompGraph> { enum { Val = 1 }; };
+}
+
+template <class PGraph>
+PCompGraph TCompGraph::New(const PGraph& Graph, const int& MnIntervalLength) {
+  typedef typename PGraph::TObj TGraph;
+  const bool IsDir = TSnap::IsDirected<TGraph>::Val;
+  PCompGraph CompGraph = new TCompGraph(IsDir, MnIntervalLength);
+  TInt64V& NIdV = CompGraph->NIdV;
+  NIdV.Gen(Graph->GetNodes(), 0);
+  for (typename TGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) { NIdV.Add(NI.GetId()); }
+  NIdV.Sort();
+  TInt64H NIdxH(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NIdxH.AddDat(NIdV[i], i); }
+  CompGraph->OutOffV.Gen(NIdV.Len()+1, 0);
+  if (IsDir) { CompGraph->InOffV.Gen(NIdV.Len()+1, 0); }
+  TInt64V NbrV;
+  int64 Edges = 0;
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    const typename TGraph::TNodeI NI = Graph->GetNI(NIdV[i]);
+    NbrV.Clr(false);
+    for (int64 e = 0; e < NI.GetOutDeg(); e++) { NbrV.Add(NIdxH.GetDat(NI.GetOutNId(e))); }
+    NbrV.Merge();
+    for (int64 e = 0; e < NbrV.Len(); e++) { if (IsDir || NbrV[e] >= i) { Edges++; } }
+    CompGraph->OutOffV.Add(CompGraph->OutBfV.Len());
+    CompGraph->AddList(i, NbrV, CompGraph->OutBfV);
+    if (IsDir) {
+      NbrV.Clr(false);
+      for (int64 e = 0; e < NI.GetInDeg(); e++) { NbrV.Add(NIdxH.GetDat(NI.GetInNId(e))); }
+      NbrV.Merge();
+      CompGraph->InOffV.Add(CompGraph->InBfV.Len());
+      CompGraph->AddList(i, NbrV, CompGraph->InBfV);
+    }
+  }
+  CompGraph->OutOffV.Add(CompGraph->OutBfV.Len());
+  if (IsDir) { CompGraph->InOffV.Add(CompGraph->InBfV.Len()); }
+  CompGraph->Edges = Edges;
+  CompGraph->OutBfV.Pack();
+  CompGraph->InBfV.Pack();
+  return CompGraph;
+}
@@ -540,6 +540,151 @@ PNGraph GenRMat(const int& Nodes, const int& Edges, const double& A, const doubl
   return GraphPt;
 }
 
+static int GetGenThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+static int GetGenThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+// Position of the first key >= Key in a sorted vector.
+static int64 GetLowerBound(const TVec<TUInt64, int64>& KeyV, const uint64& Key) {
+  int64 Lo = 0, Hi = KeyV.Len();
+  while (Lo < Hi) {
+    const int64 Mid = Lo + (Hi - Lo) / 2;
+    if (KeyV[Mid].Val < Key) { Lo = Mid + 1; } else { Hi = Mid; }
+  }
+  return Lo;
+}
+
+// Merges sorted runs of edge keys (Src << 32 | Dst) into a sorted KeyV without duplicates and clears the runs.
+// The key space is cut into chunks at keys sampled from the runs and the chunks are merged in parallel.
+static void MergeKeyRuns(TVec<TVec<TUInt64, int64> >& RunV, TVec<TUInt64, int64>& KeyV) {
+  const int Chunks = 4 * GetGenThreads();
+  TVec<TUInt64, int64> SampleV;
+  for (int r = 0; r < RunV.Len(); r++) {
+    const int64 Len = RunV[r].Len(), Samples = MIN(Len, (int64) 64 * Chunks);
+    for (int64 s = 0; s < Samples; s++) { SampleV.Add(RunV[r][Len * s / Samples]); }
+  }
+  SampleV.Sort();
+  TVec<TVec<TUInt64, int64> > ChunkKeyVV(Chunks);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < Chunks; c++) {
+    const bool First = c == 0, Last = c == Chunks - 1;
+    const uint64 BegKey = First ? 0 : SampleV[SampleV.Len() * c / Chunks].Val;
+    const uint64 EndKey = Last ? 0 : SampleV[SampleV.Len() * (c + 1) / Chunks].Val;
+    TVec<TUInt64, int64>& ChunkKeyV = ChunkKeyVV[c];
+    for (int r = 0; r < RunV.Len(); r++) {
+      const int64 Beg = First ? 0 : GetLowerBound(RunV[r], BegKey);
+      const int64 End = Last ? RunV[r].Len() : GetLowerBound(RunV[r], EndKey);
+      for (int64 k = Beg; k < End; k++) { ChunkKeyV.Add(RunV[r][k]); }
+    }
+    ChunkKeyV.Merge(); // sort and remove duplicates
+  }
+  RunV.Clr();
+  TInt64V ChunkOffV(Chunks + 1);
+  ChunkOffV[0] = 0;
+  for (int c = 0; c < Chunks; c++) { ChunkOffV[c + 1] = ChunkOffV[c] + ChunkKeyVV[c].Len(); }
+  KeyV.Gen(ChunkOffV.Last());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < Chunks; c++) {
+    for (int64 k = 0; k < ChunkKeyVV[c].Len(); k++) { KeyV[ChunkOffV[c] + k] = ChunkKeyVV[c][k]; }
+    ChunkKeyVV[c].Clr();
+  }
+}
+
+void GenRMatEdges(const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, TVec<TIntPr, int64>& EdgeV, TRnd& Rnd) {
+  IAssert(A+B+C < 1.0);
+  IAssert(Edges <= (int64) Nodes * (Nodes - 1));
+  const int Threads = GetGenThreads();
+  const int64 BlockSz = 1<<16;
+  // sum of parameters (probabilities), drawn as in GenRMat
+  TVec<double> sumA(128, 0), sumAB(128, 0), sumAC(128, 0), sumABC(128, 0);
+  for (int i = 0; i < 128; i++) {
+    const double a = A * (Rnd.GetUniDev() + 0.5);
+    const double b = B * (Rnd.GetUniDev() + 0.5);
+    const double c = C * (Rnd.GetUniDev() + 0.5);
+    const double d = (1.0 - (A+B+C)) * (Rnd.GetUniDev() + 0.5);
+    const double abcd = a+b+c+d;
+    sumA.Add(a / abcd);
+    sumAB.Add((a+b) / abcd);
+    sumAC.Add((a+c) / abcd);
+    sumABC.Add((a+b+c) / abcd);
+  }
+  // an edge takes at most MxDepth random numbers, block b of a round starts MxDepth*BlockSz*b numbers into the stream
+  int MxDepth = 0;
+  for (int Rng = Nodes; Rng > 1; Rng -= Rng/2) { MxDepth++; }
+  const int64 BaseSeed = 1 + Rnd.GetUniDevInt(TInt::Mx - 1);
+  TVec<TUInt64, int64> KeyV;
+  int64 Samples = 0;
+  while (KeyV.Len() < Edges) {
+    const int64 Need = Edges - KeyV.Len();
+    const int64 Blocks = (Need + BlockSz - 1) / BlockSz;
+    TVec<TVec<TUInt64, int64> > RunV(Threads + 1);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int64 b = 0; b < Blocks; b++) {
+      TVec<TUInt64, int64>& ThreadKeyV = RunV[GetGenThreadN()];
+      TRnd BlockRnd(BaseSeed, (Samples + b * BlockSz) * MxDepth);
+      for (int64 e = b * BlockSz; e < MIN(Need, (b + 1) * BlockSz); e++) {
+        int rngX = Nodes, rngY = Nodes, offX = 0, offY = 0, Depth = 0;
+        // recurse the matrix
+        while (rngX > 1 || rngY > 1) {
+          const double RndProb = BlockRnd.GetUniDev();
+          if (rngX>1 && rngY>1) {
+            if (RndProb < sumA[Depth]) { rngX/=2; rngY/=2; }
+            else if (RndProb < sumAB[Depth]) { offX+=rngX/2;  rngX-=rngX/2;  rngY/=2; }
+            else if (RndProb < sumABC[Depth]) { offY+=rngY/2;  rngX/=2;  rngY-=rngY/2; }
+            else { offX+=rngX/2;  offY+=rngY/2;  rngX-=rngX/2;  rngY-=rngY/2; }
+          } else
+          if (rngX>1) { // row vector
+            if (RndProb < sumAC[Depth]) { rngX/=2; rngY/=2; }
+            else { offX+=rngX/2;  rngX-=rngX/2;  rngY/=2; }
+          } else
+          if (rngY>1) { // column vector
+            if (RndProb < sumAB[Depth]) { rngX/=2; rngY/=2; }
+            else { offY+=rngY/2;  rngX/=2;  rngY-=rngY/2; }
+          } else { Fail; }
+          Depth++;
+        }
+        // skip the remaining random numbers of the edge so that every edge takes MxDepth numbers
+        for (; Depth < MxDepth; Depth++) { BlockRnd.GetUniDev(); }
+        if (offX != offY) { ThreadKeyV.Add(((uint64) offX << 32) | (uint64) offY); }
+      }
+    }
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < Threads; t++) {
+      RunV[t].Merge(); }
+    RunV.Last().Swap(KeyV);
+    MergeKeyRuns(RunV, KeyV);
+    Samples += Need;
+  }
+  EdgeV.Gen(KeyV.Len());
+  #pragma omp parallel for schedule(static)
+  for (int64 k = 0; k < KeyV.Len(); k++) {
+    EdgeV[k] = TIntPr((int) (KeyV[k].Val >> 32), (int) (KeyV[k].Val & 0xFFFFFFFF)); }
+}
+
+PNGraph GenParRMat(const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, TRnd& Rnd) {
+  TVec<TIntPr, int64> EdgeV;
+  GenRMatEdges(Nodes, Edges, A, B, C, EdgeV, Rnd);
+  PNGraph Graph = TNGraph::New(Nodes, EdgeV.Len());
+  for (int node = 0; node < Nodes; node++) {
+    Graph->AddNode(node); }
+  // edges are sorted, so the in- and out-neighbor lists come out sorted
+  for (int64 e = 0; e < EdgeV.Len(); e++) {
+    Graph->AddEdgeUnchecked(EdgeV[e].Val1, EdgeV[e].Val2); }
+  return Graph;
+}
+
 /// R-Mat generator with parameters set so that it generates a synthetic copy
 /// of the Epinions social network.
 /// The original Epinions social network can be downloaded at 
@@ -46,6 +46,10 @@ PNGraph GenForestFire(const int& Nodes, const double& FwdProb, const double& Bck
 PNGraph GenCopyModel(const int& Nodes, const double& Beta, TRnd& Rnd=TInt::Rnd);
 /// Generates a R-MAT graph using recursive descent into a 2x2 matrix [A,B; C, 1-(A+B+C)].
 PNGraph GenRMat(const int& Nodes, const int& Edges, const double& A, const double& B, const double& C, TRnd& Rnd=TInt::Rnd);
+/// Generates the edges of a R-MAT graph (see GenRMat) in parallel. Edges are sampled in blocks that draw disjoint ranges of one random stream seeded from Rnd, so the result does not depend on the number of threads. EdgeV is sorted and holds Edges distinct edges without self-loops. ##TSnap::GenRMatEdges
+void GenRMatEdges(const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, TVec<TIntPr, int64>& EdgeV, TRnd& Rnd=TInt::Rnd);
+/// Generates a R-MAT graph in parallel from the edges of GenRMatEdges().
+PNGraph GenParRMat(const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, TRnd& Rnd=TInt::Rnd);
 /// Generates a R-Mat graph, with a synthetic copy of the Epinions social network.
 PNGraph GenRMatEpinions();
 
@@ -0,0 +1,328 @@
+#ifdef GLib_LINUX
+extern "C" {
+  #include <sys/mman.h>
+}
+#endif
+
+/////////////////////////////////////////////////
+// Memory-mapped graph snapshot
+const char TMMapGraph::SnapMagic[8] = {'S', 'N', 'A', 'P', 'M', 'M', 'G', '1'};
+const int64 TMMapGraph::SnapVersion = 1;
+
+TMMapGraph::~TMMapGraph() {
+  if (Bf == NULL) { return; }
+#ifdef GLib_LINUX
+  if (IsMapped) { munmap(Bf, BfL); Bf = NULL; return; }
+#endif
+  delete [] Bf;
+  Bf = NULL;
+}
+
+void TMMapGraph::SetupPointers() {
+  EAssertR(BfL >= (int64) sizeof(THeader), "Snapshot file is too short.");
+  memcpy(&Hdr, Bf, sizeof(THeader));
+  EAssertR(memcmp(Hdr.Magic, SnapMagic, sizeof(SnapMagic)) == 0, "Not a graph snapshot file.");
+  EAssertR(Hdr.Version == SnapVersion, TStr::Fmt("Unsupported snapshot version %s.", TInt64::GetStr(Hdr.Version).CStr()));
+  const int64 Nodes = Hdr.Nodes;
+  const bool HasE = HasEId();
+  // sections follow the header in a fixed order, all sizes are multiples of 8 bytes
+  int64 Len = sizeof(THeader)/sizeof(int64);
+  Len += Nodes + (Nodes+1) + Hdr.OutNbrs*(HasE ? 2 : 1);
+  if (IsDirected()) { Len += (Nodes+1) + Hdr.InNbrs*(HasE ? 2 : 1); }
+  Len += Hdr.NmBfL/sizeof(int64);
+  Len += (Hdr.IntAttrsN + Hdr.FltAttrsN)*Nodes + (Hdr.IntAttrsE + Hdr.FltAttrsE)*Hdr.OutNbrs;
+  EAssertR(Hdr.NmBfL % sizeof(int64) == 0 && Len*(int64)sizeof(int64) == BfL, "Corrupted snapshot file.");
+
+  const int64* Cur = (const int64*) (Bf + sizeof(THeader));
+  NIdV = Cur; Cur += Nodes;
+  OutOffV = Cur; Cur += Nodes+1;
+  OutNbrV = Cur; Cur += Hdr.OutNbrs;
+  if (HasE) { OutEIdV = Cur; Cur += Hdr.OutNbrs; }
+  if (IsDirected()) {
+    InOffV = Cur; Cur += Nodes+1;
+    InNbrV = Cur; Cur += Hdr.InNbrs;
+    if (HasE) { InEIdV = Cur; Cur += Hdr.InNbrs; }
+  } else {
+    InOffV = OutOffV; InNbrV = OutNbrV; InEIdV = OutEIdV;
+  }
+  // attribute names are stored as consecutive null-terminated strings
+  const char* NmBf = (const char*) Cur;
+  int64 NmC = 0;
+  TStrInt64H* AttrHV[] = {&IntAttrNH, &FltAttrNH, &IntAttrEH, &FltAttrEH};
+  const int64 AttrsV[] = {Hdr.IntAttrsN, Hdr.FltAttrsN, Hdr.IntAttrsE, Hdr.FltAttrsE};
+  for (int i = 0; i < 4; i++) {
+    for (int64 j = 0; j < AttrsV[i]; j++) {
+      EAssertR(NmC < Hdr.NmBfL, "Corrupted snapshot attribute names.");
+      const TStr AttrName(NmBf+NmC);
+      AttrHV[i]->AddDat(AttrName, j);
+      NmC += AttrName.Len()+1;
+    }
+  }
+  Cur += Hdr.NmBfL/sizeof(int64);
+  IntColN = Cur; Cur += Hdr.IntAttrsN*Nodes;
+  FltColN = (const double*) Cur; Cur += Hdr.FltAttrsN*Nodes;
+  IntColE = Cur; Cur += Hdr.IntAttrsE*Hdr.OutNbrs;
+  FltColE = (const double*) Cur; Cur += Hdr.FltAttrsE*Hdr.OutNbrs;
+}
+
+PMMapGraph TMMapGraph::Load(const TStr& FNm) {
+  PMMapGraph Graph = new TMMapGraph();
+  EAssertR(!FNm.Empty(), "Empty file-name.");
+  FILE* FileId = fopen(FNm.CStr(), "rb");
+  EAssertR(FileId != NULL, "Can not open file '"+FNm+"'.");
+  EAssertR(fseek(FileId, 0, SEEK_END) == 0, "Error seeking into file '"+FNm+"'.");
+  Graph->BfL = (int64) ftell(FileId);
+  EAssertR(fseek(FileId, 0, SEEK_SET) == 0, "Error seeking into file '"+FNm+"'.");
+#ifdef GLib_LINUX
+  // read-only shared mapping: pages come straight from the page cache and are never copied
+  void* Mapped = mmap(0, Graph->BfL, PROT_READ, MAP_SHARED, fileno(FileId), 0);
+  fclose(FileId);
+  EAssertR(Mapped != MAP_FAILED, "mmap failed in TMMapGraph::Load.");
+  Graph->Bf = (char*) Mapped;
+  Graph->IsMapped = true;
+#else
+  Graph->Bf = new char[Graph->BfL];
+  const size_t ReadL = fread(Graph->Bf, 1, Graph->BfL, FileId);
+  fclose(FileId);
+  EAssertR((int64) ReadL == Graph->BfL, "Error reading file '"+FNm+"'.");
+#endif
+  Graph->SetupPointers();
+  return Graph;
+}
+
+void TMMapGraph::SaveSnapshot(const TStr& FNm, THeader& Hdr, const TInt64V& NIdV, const TInt64V& OutOffV,
+ const TInt64V& OutNbrV, const TInt64V& OutEIdV, const TInt64V& InOffV, const TInt64V& InNbrV,
+ const TInt64V& InEIdV, const TStr64V& AttrNmV, const TInt64V& IntAttrV, const TFltV& FltAttrV) {
+  memcpy(Hdr.Magic, SnapMagic, sizeof(SnapMagic));
+  Hdr.Version = SnapVersion;
+  TChA NmBf;
+  for (int64 i = 0; i < AttrNmV.Len(); i++) { NmBf += AttrNmV[i]; NmBf += '\0'; }
+  while (NmBf.Len() % sizeof(int64) != 0) { NmBf += '\0'; }
+  Hdr.NmBfL = NmBf.Len();
+  TFOut SOut(FNm);
+  SOut.SaveBf(&Hdr, sizeof(THeader));
+  const TInt64V* SecV[] = {&NIdV, &OutOffV, &OutNbrV, &OutEIdV, &InOffV, &InNbrV, &InEIdV};
+  for (int i = 0; i < 7; i++) {
+    if (! SecV[i]->Empty()) { SOut.SaveBf(SecV[i]->BegI(), SecV[i]->Len()*sizeof(int64)); }
+  }
+  if (NmBf.Len() > 0) { SOut.SaveBf(NmBf.CStr(), NmBf.Len()); }
+  // int columns precede float columns within both the node and the edge block
+  const int64 NIntN = Hdr.IntAttrsN*Hdr.Nodes, NFltN = Hdr.FltAttrsN*Hdr.Nodes;
+  if (NIntN > 0) { SOut.SaveBf(IntAttrV.BegI(), NIntN*sizeof(int64)); }
+  if (NFltN > 0) { SOut.SaveBf(FltAttrV.BegI(), NFltN*sizeof(double)); }
+  if (IntAttrV.Len() > NIntN) { SOut.SaveBf(IntAttrV.BegI()+NIntN, (IntAttrV.Len()-NIntN)*sizeof(int64)); }
+  if (FltAttrV.Len() > NFltN) { SOut.SaveBf(FltAttrV.BegI()+NFltN, (FltAttrV.Len()-NFltN)*sizeof(double)); }
+}
+
+template <class PGraph>
+void TMMapGraph::SaveGraph(const TStr& FNm, const PGraph& Graph) {
+  typedef typename PGraph::TObj TGraph;
+  const bool IsDir = TSnap::IsDirected<TGraph>::Val;
+  THeader Hdr;
+  memset(&Hdr, 0, sizeof(THeader));
+  Hdr.Flags = IsDir ? FlagDirected : 0;
+  Hdr.Nodes = Graph->GetNodes();
+  Hdr.Edges = Graph->GetEdges();
+  Hdr.MxNId = Graph->GetMxNId()-1;
+  Hdr.MxEId = -1;
+  TInt64V NIdV, OutOffV, OutNbrV, InOffV, InNbrV, EmptyV;
+  Graph->GetNIdV(NIdV);
+  NIdV.Sort();
+  if (! NIdV.Empty()) { Hdr.MxNId = NIdV.Last(); }
+  TInt64H NIdxH(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NIdxH.AddDat(NIdV[i], i); }
+  OutOffV.Gen(NIdV.Len()+1);
+  if (IsDir) { InOffV.Gen(NIdV.Len()+1); }
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    const typename TGraph::TNodeI NI = Graph->GetNI(NIdV[i]);
+    // node ids in adjacency vectors are sorted, so are their indices
+    const int64 OutDeg = IsDir ? NI.GetOutDeg() : NI.GetDeg();
+    for (int64 e = 0; e < OutDeg; e++) {
+      OutNbrV.Add(NIdxH.GetDat(IsDir ? NI.GetOutNId(e) : NI.GetNbrNId(e)));
+    }
+    OutOffV[i+1] = OutNbrV.Len();
+    if (IsDir) {
+      for (int64 e = 0; e < NI.GetInDeg(); e++) { InNbrV.Add(NIdxH.GetDat(NI.GetInNId(e))); }
+      InOffV[i+1] = InNbrV.Len();
+    }
+  }
+  Hdr.OutNbrs = OutNbrV.Len();
+  Hdr.InNbrs = IsDir ? InNbrV.Len() : OutNbrV.Len();
+  SaveSnapshot(FNm, Hdr, NIdV, OutOffV, OutNbrV, EmptyV, InOffV, InNbrV, EmptyV, TStr64V(), TInt64V(), TFltV());
+}
+
+void TMMapGraph::Save(const TStr& FNm, const PUNGraph& Graph) {
+  SaveGraph(FNm, Graph);
+}
+
+void TMMapGraph::Save(const TStr& FNm, const PNGraph& Graph) {
+  SaveGraph(FNm, Graph);
+}
+
+void TMMapGraph::Save(const TStr& FNm, const PNEANet& Graph) {
+  THeader Hdr;
+  memset(&Hdr, 0, sizeof(THeader));
+  Hdr.Flags = FlagDirected | FlagMulti | FlagEId;
+  Hdr.Nodes = Graph->GetNodes();
+  Hdr.Edges = Graph->GetEdges();
+  Hdr.MxNId = -1;
+  Hdr.MxEId = -1;
+  TInt64V NIdV, OutOffV, OutNbrV, OutEIdV, InOffV, InNbrV, InEIdV;
+  for (TNEANet::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) { NIdV.Add(NI.GetId()); }
+  NIdV.Sort();
+  if (! NIdV.Empty()) { Hdr.MxNId = NIdV.Last(); }
+  TInt64H NIdxH(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NIdxH.AddDat(NIdV[i], i); }
+  OutOffV.Gen(NIdV.Len()+1);
+  InOffV.Gen(NIdV.Len()+1);
+  TIntPr64V NbrV;
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    const TNEANet::TNodeI NI = Graph->GetNI(NIdV[i]);
+    // parallel edges are ordered by neighbor index, then by edge id
+    NbrV.Clr(false);
+    for (int64 e = 0; e < NI.GetOutDeg(); e++) {
+      NbrV.Add(TInt64Pr(NIdxH.GetDat(NI.GetOutNId(e)), NI.GetOutEId(e)));
+    }
+    NbrV.Sort();
+    for (int64 e = 0; e < NbrV.Len(); e++) {
+      OutNbrV.Add(NbrV[e].Val1); OutEIdV.Add(NbrV[e].Val2);
+      if (NbrV[e].Val2 > Hdr.MxEId) { Hdr.MxEId = NbrV[e].Val2; }
+    }
+    OutOffV[i+1] = OutNbrV.Len();
+    NbrV.Clr(false);
+    for (int64 e = 0; e < NI.GetInDeg(); e++) {
+      NbrV.Add(TInt64Pr(NIdxH.GetDat(NI.GetInNId(e)), NI.GetInEId(e)));
+    }
+    NbrV.Sort();
+    for (int64 e = 0; e < NbrV.Len(); e++) { InNbrV.Add(NbrV[e].Val1); InEIdV.Add(NbrV[e].Val2); }
+    InOffV[i+1] = InNbrV.Len();
+  }
+  Hdr.OutNbrs = OutNbrV.Len();
+  Hdr.InNbrs = InNbrV.Len();
+  // string attributes have no fixed-width representation and are not stored
+  TStr64V IntNmN, FltNmN, StrNmN, IntNmE, FltNmE, StrNmE, AttrNmV;
+  Graph->GetAttrNNames(IntNmN, FltNmN, StrNmN);
+  Graph->GetAttrENames(IntNmE, FltNmE, StrNmE);
+  Hdr.IntAttrsN = IntNmN.Len(); Hdr.FltAttrsN = FltNmN.Len();
+  Hdr.IntAttrsE = IntNmE.Len(); Hdr.FltAttrsE = FltNmE.Len();
+  AttrNmV.AddV(IntNmN); AttrNmV.AddV(FltNmN); AttrNmV.AddV(IntNmE); AttrNmV.AddV(FltNmE);
+  TInt64V IntAttrV((IntNmN.Len()*NIdV.Len()) + (IntNmE.Len()*OutEIdV.Len()), 0);
+  TFltV FltAttrV((FltNmN.Len()*NIdV.Len()) + (FltNmE.Len()*OutEIdV.Len()), 0);
+  for (int64 a = 0; a < IntNmN.Len(); a++) {
+    for (int64 i = 0; i < NIdV.Len(); i++) { IntAttrV.Add(Graph->GetIntAttrDatN(NIdV[i], IntNmN[a])); }
+  }
+  for (int64 a = 0; a < FltNmN.Len(); a++) {
+    for (int64 i = 0; i < NIdV.Len(); i++) { FltAttrV.Add(Graph->GetFltAttrDatN(NIdV[i], FltNmN[a])); }
+  }
+  for (int64 a = 0; a < IntNmE.Len(); a++) {
+    for (int64 e = 0; e < OutEIdV.Len(); e++) { IntAttrV.Add(Graph->GetIntAttrDatE(OutEIdV[e], IntNmE[a])); }
+  }
+  for (int64 a = 0; a < FltNmE.Len(); a++) {
+    for (int64 e = 0; e < OutEIdV.Len(); e++) { FltAttrV.Add(Graph->GetFltAttrDatE(OutEIdV[e], FltNmE[a])); }
+  }
+  SaveSnapshot(FNm, Hdr, NIdV, OutOffV, OutNbrV, OutEIdV, InOffV, InNbrV, InEIdV, AttrNmV, IntAttrV, FltAttrV);
+}
+
+int64 TMMapGraph::GetNIdx(const int64& NId) const {
+  const int64* Pos = std::lower_bound(NIdV, NIdV+Hdr.Nodes, NId);
+  return (Pos != NIdV+Hdr.Nodes && *Pos == NId) ? Pos-NIdV : -1;
+}
+
+bool TMMapGraph::IsSortedNbr(const int64* NbrV, const int64& Len, const int64& Idx) {
+  const int64* Pos = std::lower_bound(NbrV, NbrV+Len, Idx);
+  return Pos != NbrV+Len && *Pos == Idx;
+}
+
+bool TMMapGraph::TNodeI::IsInNId(const int64& NId) const {
+  const int64 Idx = Graph->GetNIdx(NId);
+  return Idx != -1 && IsSortedNbr(GetInNIdxV(), GetInDeg(), Idx);
+}
+
+bool TMMapGraph::TNodeI::IsOutNId(const int64& NId) const {
+  const int64 Idx = Graph->GetNIdx(NId);
+  return Idx != -1 && IsSortedNbr(GetOutNIdxV(), GetOutDeg(), Idx);
+}
+
+int64 TMMapGraph::GetOutPos(const int64& SrcNIdx, const int64& DstNIdx) const {
+  if (SrcNIdx == -1 || DstNIdx == -1) { return -1; }
+  const int64* Beg = OutNbrV+OutOffV[SrcNIdx];
+  const int64* End = OutNbrV+OutOffV[SrcNIdx+1];
+  const int64* Pos = std::lower_bound(Beg, End, DstNIdx);
+  return (Pos != End && *Pos == DstNIdx) ? Pos-OutNbrV : -1;
+}
+
+bool TMMapGraph::IsEdge(const int64& SrcNId, const int64& DstNId) const {
+  return GetOutPos(GetNIdx(SrcNId), GetNIdx(DstNId)) != -1;
+}
+
+TMMapGraph::TEdgeI TMMapGraph::GetEI(const int64& SrcNId, const int64& DstNId) const {
+  const int64 SrcNIdx = GetNIdx(SrcNId);
+  const int64 EPos = GetOutPos(SrcNIdx, GetNIdx(DstNId));
+  if (EPos == -1) { return EndEI(); }
+  return TEdgeI(SrcNIdx, EPos, this);
+}
+
+void TMMapGraph::SkipEdges(int64& NIdx, int64& EPos) const {
+  // advance the source node past exhausted adjacency ranges
+  while (NIdx < Hdr.Nodes && OutOffV[NIdx+1] <= EPos) { NIdx++; }
+  if (IsDirected() || NIdx >= Hdr.Nodes) { return; }
+  // undirected edges are stored twice, visit only the copy with Src<=Dst
+  while (NIdx < Hdr.Nodes && OutNbrV[EPos] < NIdx) {
+    EPos++;
+    while (NIdx < Hdr.Nodes && OutOffV[NIdx+1] <= EPos) { NIdx++; }
+  }
+}
+
+void TMMapGraph::GetAttrNNames(TStr64V& IntAttrNames, TStr64V& FltAttrNames) const {
+  IntAttrNH.GetKeyV(IntAttrNames);
+  FltAttrNH.GetKeyV(FltAttrNames);
+}
+
+void TMMapGraph::GetAttrENames(TStr64V& IntAttrNames, TStr64V& FltAttrNames) const {
+  IntAttrEH.GetKeyV(IntAttrNames);
+  FltAttrEH.GetKeyV(FltAttrNames);
+}
+
+const int64* TMMapGraph::GetIntAttrColN(const TStr& AttrName) const {
+  const int64 KeyId = IntAttrNH.GetKeyId(AttrName);
+  return KeyId == -1 ? NULL : IntColN + IntAttrNH[KeyId]*Hdr.Nodes;
+}
+
+const double* TMMapGraph::GetFltAttrColN(const TStr& AttrName) const {
+  const int64 KeyId = FltAttrNH.GetKeyId(AttrName);
+  return KeyId == -1 ? NULL : FltColN + FltAttrNH[KeyId]*Hdr.Nodes;
+}
+
+const int64* TMMapGraph::GetIntAttrColE(const TStr& AttrName) const {
+  const int64 KeyId = IntAttrEH.GetKeyId(AttrName);
+  return KeyId == -1 ? NULL : IntColE + IntAttrEH[KeyId]*Hdr.OutNbrs;
+}
+
+const double* TMMapGraph::GetFltAttrColE(const TStr& AttrName) const {
+  const int64 KeyId = FltAttrEH.GetKeyId(AttrName);
+  return KeyId == -1 ? NULL : FltColE + FltAttrEH[KeyId]*Hdr.OutNbrs;
+}
+
+int64 TMMapGraph::GetIntAttrDatN(const TNodeI& NodeI, const TStr& AttrName) const {
+  const int64* ColV = GetIntAttrColN(AttrName);
+  EAssertR(ColV != NULL, "Unknown node attribute '"+AttrName+"'.");
+  return ColV[NodeI.NIdx];
+}
+
+double TMMapGraph::GetFltAttrDatN(const TNodeI& NodeI, const TStr& AttrName) const {
+  const double* ColV = GetFltAttrColN(AttrName);
+  EAssertR(ColV != NULL, "Unknown node attribute '"+AttrName+"'.");
+  return ColV[NodeI.NIdx];
+}
+
+int64 TMMapGraph::GetIntAttrDatE(const TEdgeI& EdgeI, const TStr& AttrName) const {
+  const int64* ColV = GetIntAttrColE(AttrName);
+  EAssertR(ColV != NULL, "Unknown edge attribute '"+AttrName+"'.");
+  return ColV[EdgeI.EPos];
+}
+
+double TMMapGraph::GetFltAttrDatE(const TEdgeI& EdgeI, const TStr& AttrName) const {
+  const double* ColV = GetFltAttrColE(AttrName);
+  EAssertR(ColV != NULL, "Unknown edge attribute '"+AttrName+"'.");
+  return ColV[EdgeI.EPos];
+}
@@ -0,0 +1,205 @@
+//#//////////////////////////////////////////////
+/// Memory-mapped read-only graph snapshot.
+class TMMapGraph;
+/// Pointer to a memory-mapped graph snapshot (TMMapGraph).
+typedef TPt<TMMapGraph> PMMapGraph;
+
+/// Read-only graph backed by a memory-mapped snapshot file.
+/// A snapshot stores a graph in compressed sparse row (CSR) form: a sorted array
+/// of node ids, per-node offsets into the out- (and for directed graphs in-)
+/// neighbor arrays, optional edge ids and dense int/float attribute columns.
+/// All sections are 8-byte aligned, so TMMapGraph::Load() maps the file and sets
+/// a handful of pointers into the mapping. No per-node work is done on load and
+/// the pages are shared through the OS page cache between processes that load
+/// the same snapshot. Neighbors are addressed by node index (position in the
+/// sorted node id array); NIds are obtained through the index.
+class TMMapGraph {
+public:
+  typedef TMMapGraph TNet;
+  typedef TPt<TMMapGraph> PNet;
+private:
+  /// Snapshot file header. All fields are 64-bit so the data that follows is 8-byte aligned.
+  struct THeader {
+    char Magic[8];
+    int64 Version, Flags;
+    int64 Nodes, Edges, MxNId, MxEId;
+    int64 OutNbrs, InNbrs;
+    int64 IntAttrsN, FltAttrsN, IntAttrsE, FltAttrsE;
+    int64 NmBfL;
+  };
+  enum { FlagDirected = 1, FlagMulti = 2, FlagEId = 4 };
+  static const char SnapMagic[8];
+  static const int64 SnapVersion;
+public:
+  /// Node iterator. Nodes are visited in increasing order of their ids.
+  class TNodeI {
+  private:
+    const TMMapGraph* Graph;
+    int64 NIdx;
+  public:
+    TNodeI() : Graph(NULL), NIdx(0) { }
+    TNodeI(const int64& NodeIdx, const TMMapGraph* GraphPt) : Graph(GraphPt), NIdx(NodeIdx) { }
+    TNodeI(const TNodeI& NodeI) : Graph(NodeI.Graph), NIdx(NodeI.NIdx) { }
+    TNodeI& operator = (const TNodeI& NodeI) { Graph=NodeI.Graph; NIdx=NodeI.NIdx; return *this; }
+    /// Increment iterator.
+    TNodeI& operator++ (int) { NIdx++; return *this; }
+    bool operator < (const TNodeI& NodeI) const { return NIdx < NodeI.NIdx; }
+    bool operator == (const TNodeI& NodeI) const { return NIdx == NodeI.NIdx; }
+    /// Returns ID of the current node.
+    int64 GetId() const { return Graph->NIdV[NIdx]; }
+    /// Returns index of the current node in the snapshot.
+    int64 GetIdx() const { return NIdx; }
+    /// Returns degree of the current node, the sum of in-degree and out-degree.
+    int64 GetDeg() const { return Graph->IsDirected() ? GetInDeg()+GetOutDeg() : GetOutDeg(); }
+    /// Returns in-degree of the current node.
+    int64 GetInDeg() const { return Graph->InOffV[NIdx+1]-Graph->InOffV[NIdx]; }
+    /// Returns out-degree of the current node.
+    int64 GetOutDeg() const { return Graph->OutOffV[NIdx+1]-Graph->OutOffV[NIdx]; }
+    /// Returns ID of EdgeN-th in-node (the node pointing to the current node).
+    int64 GetInNId(const int64& EdgeN) const { return Graph->NIdV[GetInNIdx(EdgeN)]; }
+    /// Returns ID of EdgeN-th out-node (the node the current node points to).
+    int64 GetOutNId(const int64& EdgeN) const { return Graph->NIdV[GetOutNIdx(EdgeN)]; }
+    /// Returns ID of EdgeN-th neighboring node.
+    int64 GetNbrNId(const int64& EdgeN) const { return EdgeN<GetOutDeg() ? GetOutNId(EdgeN) : GetInNId(EdgeN-GetOutDeg()); }
+    /// Returns index of EdgeN-th in-node.
+    int64 GetInNIdx(const int64& EdgeN) const { return Graph->InNbrV[Graph->InOffV[NIdx]+EdgeN]; }
+    /// Returns index of EdgeN-th out-node.
+    int64 GetOutNIdx(const int64& EdgeN) const { return Graph->OutNbrV[Graph->OutOffV[NIdx]+EdgeN]; }
+    /// Returns ID of EdgeN-th in-edge. Returns -1 if the snapshot stores no edge ids.
+    int64 GetInEId(const int64& EdgeN) const { return Graph->InEIdV==NULL ? -1 : Graph->InEIdV[Graph->InOffV[NIdx]+EdgeN]; }
+    /// Returns ID of EdgeN-th out-edge. Returns -1 if the snapshot stores no edge ids.
+    int64 GetOutEId(const int64& EdgeN) const { return Graph->OutEIdV==NULL ? -1 : Graph->OutEIdV[Graph->OutOffV[NIdx]+EdgeN]; }
+    /// Returns pointer to the out-neighbor indices of the current node.
+    const int64* GetOutNIdxV() const { return Graph->OutNbrV+Graph->OutOffV[NIdx]; }
+    /// Returns pointer to the in-neighbor indices of the current node.
+    const int64* GetInNIdxV() const { return Graph->InNbrV+Graph->InOffV[NIdx]; }
+    /// Tests whether node with ID NId points to the current node.
+    bool IsInNId(const int64& NId) const;
+    /// Tests whether the current node points to node with ID NId.
+    bool IsOutNId(const int64& NId) const;
+    /// Tests whether node with ID NId is a neighbor of the current node.
+    bool IsNbrNId(const int64& NId) const { return IsOutNId(NId) || IsInNId(NId); }
+    friend class TMMapGraph;
+  };
+  /// Edge iterator. Edges are visited in the order of the out-neighbor arrays.
+  class TEdgeI {
+  private:
+    const TMMapGraph* Graph;
+    int64 NIdx, EPos;
+  public:
+    TEdgeI() : Graph(NULL), NIdx(0), EPos(0) { }
+    TEdgeI(const int64& NodeIdx, const int64& EdgePos, const TMMapGraph* GraphPt) : Graph(GraphPt), NIdx(NodeIdx), EPos(EdgePos) { }
+    TEdgeI(const TEdgeI& EdgeI) : Graph(EdgeI.Graph), NIdx(EdgeI.NIdx), EPos(EdgeI.EPos) { }
+    TEdgeI& operator = (const TEdgeI& EdgeI) { Graph=EdgeI.Graph; NIdx=EdgeI.NIdx; EPos=EdgeI.EPos; return *this; }
+    /// Increment iterator.
+    TEdgeI& operator++ (int) { EPos++; Graph->SkipEdges(NIdx, EPos); return *this; }
+    bool operator < (const TEdgeI& EdgeI) const { return EPos < EdgeI.EPos; }
+    bool operator == (const TEdgeI& EdgeI) const { return EPos == EdgeI.EPos; }
+    /// Returns edge ID. Returns -1 if the snapshot stores no edge ids.
+    int64 GetId() const { return Graph->OutEIdV==NULL ? -1 : Graph->OutEIdV[EPos]; }
+    /// Returns position of the edge in the out-neighbor array (the index of its attribute values).
+    int64 GetPos() const { return EPos; }
+    /// Returns the source node of the edge.
+    int64 GetSrcNId() const { return Graph->NIdV[NIdx]; }
+    /// Returns the destination node of the edge.
+    int64 GetDstNId() const { return Graph->NIdV[Graph->OutNbrV[EPos]]; }
+    friend class TMMapGraph;
+  };
+private:
+  TCRef CRef;
+  char* Bf;
+  int64 BfL;
+  bool IsMapped;
+  THeader Hdr;
+  const int64 *NIdV, *OutOffV, *OutNbrV, *OutEIdV, *InOffV, *InNbrV, *InEIdV;
+  const int64 *IntColN, *IntColE;
+  const double *FltColN, *FltColE;
+  TStrInt64H IntAttrNH, FltAttrNH, IntAttrEH, FltAttrEH;
+private:
+  TMMapGraph() : CRef(), Bf(NULL), BfL(0), IsMapped(false), NIdV(NULL), OutOffV(NULL), OutNbrV(NULL),
+    OutEIdV(NULL), InOffV(NULL), InNbrV(NULL), InEIdV(NULL), IntColN(NULL), IntColE(NULL), FltColN(NULL), FltColE(NULL) { }
+  UndefCopyAssign(TMMapGraph);
+  void SetupPointers();
+  void SkipEdges(int64& NIdx, int64& EPos) const;
+  int64 GetOutPos(const int64& SrcNIdx, const int64& DstNIdx) const;
+  static bool IsSortedNbr(const int64* NbrV, const int64& Len, const int64& Idx);
+  static void SaveSnapshot(const TStr& FNm, THeader& Hdr, const TInt64V& NIdV, const TInt64V& OutOffV,
+    const TInt64V& OutNbrV, const TInt64V& OutEIdV, const TInt64V& InOffV, const TInt64V& InNbrV,
+    const TInt64V& InEIdV, const TStr64V& AttrNmV, const TInt64V& IntAttrV, const TFltV& FltAttrV);
+  template <class PGraph> static void SaveGraph(const TStr& FNm, const PGraph& Graph);
+public:
+  ~TMMapGraph();
+  /// Loads a snapshot with a read-only, shared memory mapping of file FNm.
+  static PMMapGraph Load(const TStr& FNm);
+  /// Saves an undirected graph as a snapshot file FNm.
+  static void Save(const TStr& FNm, const PUNGraph& Graph);
+  /// Saves a directed graph as a snapshot file FNm.
+  static void Save(const TStr& FNm, const PNGraph& Graph);
+  /// Saves a directed multigraph with edge ids and its int and float node/edge attributes as a snapshot file FNm.
+  static void Save(const TStr& FNm, const PNEANet& Graph);
+
+  /// Tests whether the snapshot is a directed graph.
+  bool IsDirected() const { return (Hdr.Flags & FlagDirected) != 0; }
+  /// Tests whether the snapshot is a multigraph.
+  bool IsMultiGraph() const { return (Hdr.Flags & FlagMulti) != 0; }
+  /// Tests whether the snapshot stores edge ids.
+  bool HasEId() const { return (Hdr.Flags & FlagEId) != 0; }
+  /// Tests whether the snapshot is backed by a memory mapping (as opposed to a heap buffer).
+  bool IsMemoryMapped() const { return IsMapped; }
+  /// Returns the number of nodes in the graph.
+  int64 GetNodes() const { return Hdr.Nodes; }
+  /// Returns the number of edges in the graph.
+  int64 GetEdges() const { return Hdr.Edges; }
+  /// Returns the maximum node id in the graph.
+  int64 GetMxNId() const { return Hdr.MxNId; }
+  /// Returns the maximum edge id in the graph, or -1 if the snapshot stores no edge ids.
+  int64 GetMxEId() const { return Hdr.MxEId; }
+  /// Returns the index of node NId, or -1 if the node does not exist.
+  int64 GetNIdx(const int64& NId) const;
+  /// Returns the ID of the node at index NIdx.
+  int64 GetNId(const int64& NIdx) const { return NIdV[NIdx]; }
+  /// Tests whether ID NId is a node.
+  bool IsNode(const int64& NId) const { return GetNIdx(NId) != -1; }
+  /// Tests whether an edge from node IDs SrcNId to DstNId exists.
+  bool IsEdge(const int64& SrcNId, const int64& DstNId) const;
+  /// Returns an iterator referring to the first node in the graph.
+  TNodeI BegNI() const { return TNodeI(0, this); }
+  /// Returns an iterator referring to the past-the-end node in the graph.
+  TNodeI EndNI() const { return TNodeI(Hdr.Nodes, this); }
+  /// Returns an iterator referring to the node of ID NId in the graph.
+  TNodeI GetNI(const int64& NId) const { return TNodeI(GetNIdx(NId), this); }
+  /// Returns an iterator referring to the first edge in the graph.
+  TEdgeI BegEI() const { int64 NIdx=0, EPos=0; SkipEdges(NIdx, EPos); return TEdgeI(NIdx, EPos, this); }
+  /// Returns an iterator referring to the past-the-end edge in the graph.
+  TEdgeI EndEI() const { return TEdgeI(Hdr.Nodes, Hdr.OutNbrs, this); }
+  /// Returns an iterator referring to edge (SrcNId, DstNId) in the graph.
+  TEdgeI GetEI(const int64& SrcNId, const int64& DstNId) const;
+
+  /// Returns the names of int and float node attributes stored in the snapshot.
+  void GetAttrNNames(TStr64V& IntAttrNames, TStr64V& FltAttrNames) const;
+  /// Returns the names of int and float edge attributes stored in the snapshot.
+  void GetAttrENames(TStr64V& IntAttrNames, TStr64V& FltAttrNames) const;
+  /// Returns the column of int node attribute AttrName, indexed by node index, or NULL if there is no such attribute.
+  const int64* GetIntAttrColN(const TStr& AttrName) const;
+  /// Returns the column of float node attribute AttrName, indexed by node index, or NULL if there is no such attribute.
+  const double* GetFltAttrColN(const TStr& AttrName) const;
+  /// Returns the column of int edge attribute AttrName, indexed by edge position, or NULL if there is no such attribute.
+  const int64* GetIntAttrColE(const TStr& AttrName) const;
+  /// Returns the column of float edge attribute AttrName, indexed by edge position, or NULL if there is no such attribute.
+  const double* GetFltAttrColE(const TStr& AttrName) const;
+  /// Returns the value of int attribute AttrName of node NodeI.
+  int64 GetIntAttrDatN(const TNodeI& NodeI, const TStr& AttrName) const;
+  /// Returns the value of float attribute AttrName of node NodeI.
+  double GetFltAttrDatN(const TNodeI& NodeI, const TStr& AttrName) const;
+  /// Returns the value of int attribute AttrName of edge EdgeI.
+  int64 GetIntAttrDatE(const TEdgeI& EdgeI, const TStr& AttrName) const;
+  /// Returns the value of float attribute AttrName of edge EdgeI.
+  double GetFltAttrDatE(const TEdgeI& EdgeI, const TStr& AttrName) const;
+
+  friend class TPt<TMMapGraph>;
+};
+
+// set flags
+namespace TSnap {
+template <> struct IsDirected<TMMapGraph> { enum { Val = 1 }; };
+}
@@ -830,6 +830,30 @@ PMMNet TMMNet::GetSubgraphByModeNet(TStr64V& ModeNetTypes) {
   return Result;
 }
 
+PMMNetView TMMNet::GetSubgraphViewByCrossNet(const TStr64V& CrossNetTypes) const {
+  TInt64V ModeIds, CrossIds(CrossNetTypes.Len(), 0);
+  for (int64 i = 0; i < CrossNetTypes.Len(); i++) {
+    CrossIds.Add(CrossNameToIdH.GetDat(CrossNetTypes[i]));
+  }
+  return TMMNetView::New(this, ModeIds, CrossIds);
+}
+
+PMMNetView TMMNet::GetSubgraphViewByModeNet(const TStr64V& ModeNetTypes) const {
+  TInt64V ModeIds(ModeNetTypes.Len(), 0), CrossIds;
+  THashSet<TInt64, int64> ModeTypeIds;
+  for (int64 i = 0; i < ModeNetTypes.Len(); i++) {
+    ModeIds.Add(ModeNameToIdH.GetDat(ModeNetTypes[i]));
+    ModeTypeIds.AddKey(ModeIds.Last());
+  }
+  for (THash<TInt64, TCrossNet, int64>::TIter it = TCrossNetH.BegI(); it < TCrossNetH.EndI(); it++) {
+    const TCrossNet& CrossNet = it.GetDat();
+    if (ModeTypeIds.IsKey(CrossNet.Mode1) && ModeTypeIds.IsKey(CrossNet.Mode2)) {
+      CrossIds.Add(it.GetKey());
+    }
+  }
+  return TMMNetView::New(this, ModeIds, CrossIds);
+}
+
 PNEANet TMMNet::ToNetwork(TInt64V& CrossNetTypes, TIntStrStrTr64V& NodeAttrMap, TVec<TTriple<TInt64, TStr, TStr>, int64>& EdgeAttrMap) {
   TIntPrInt64H NodeMap;
   THash<TInt64Pr, TInt64Pr, int64> EdgeMap;
@@ -1326,3 +1350,233 @@ int64 TMMNet::AddEdgeAttributes(PNEANet& NewNet, TCrossNet& Net, TVec<TPair<TStr
   }
   return 0;
 }
+
+////////////////////////////////////////////////
+// Multimodal network view
+
+const TInt64V TMMNetView::EmptyV;
+
+TMMNetView::TMMNetView(const TMMNet* MMNet, const TInt64V& ModeIds, const TInt64V& CrossIds) : CRef(), Net(MMNet),
+  ModeIdV(), CrossIdV(), ModeNetV(), CrossNetV(), ModeOffV(), CrossOffV(), CrossModeNV(), ModeIdToNH(), CrossIdToNH(), NbrSlotVV() {
+  // collect the modes and crossnets, endpoint modes of the crossnets are always part of the view
+  for (int64 i = 0; i < ModeIds.Len(); i++) {
+    if (ModeIdToNH.IsKey(ModeIds[i])) { continue; }
+    ModeIdToNH.AddDat(ModeIds[i], ModeIdV.Len());
+    ModeIdV.Add(ModeIds[i]);
+  }
+  for (int64 i = 0; i < CrossIds.Len(); i++) {
+    if (CrossIdToNH.IsKey(CrossIds[i])) { continue; }
+    const TCrossNet& CrossNet = Net->GetCrossNetById(CrossIds[i]);
+    CrossIdToNH.AddDat(CrossIds[i], CrossIdV.Len());
+    CrossIdV.Add(CrossIds[i]);
+    if (!ModeIdToNH.IsKey(CrossNet.Mode1)) { ModeIdToNH.AddDat(CrossNet.Mode1, ModeIdV.Len()); ModeIdV.Add(CrossNet.Mode1); }
+    if (!ModeIdToNH.IsKey(CrossNet.Mode2)) { ModeIdToNH.AddDat(CrossNet.Mode2, ModeIdV.Len()); ModeIdV.Add(CrossNet.Mode2); }
+  }
+  // view-wide ids are the mode/crossnet local ids shifted by the sizes of the preceding modes/crossnets
+  int64 Off = 0;
+  ModeNetV.Gen(ModeIdV.Len(), 0);  ModeOffV.Gen(ModeIdV.Len()+1, 0);
+  for (int64 m = 0; m < ModeIdV.Len(); m++) {
+    ModeNetV.Add(&Net->GetModeNetById(ModeIdV[m]));
+    ModeOffV.Add(Off);
+    Off += ModeNetV.Last()->GetMxNId();
+  }
+  ModeOffV.Add(Off);
+  Off = 0;
+  CrossNetV.Gen(CrossIdV.Len(), 0);  CrossOffV.Gen(CrossIdV.Len()+1, 0);  CrossModeNV.Gen(CrossIdV.Len(), 0);
+  for (int64 c = 0; c < CrossIdV.Len(); c++) {
+    CrossNetV.Add(&Net->GetCrossNetById(CrossIdV[c]));
+    CrossOffV.Add(Off);
+    Off += CrossNetV.Last()->GetMxEId();
+    CrossModeNV.Add(TInt64Pr(ModeIdToNH.GetDat(CrossNetV.Last()->Mode1), ModeIdToNH.GetDat(CrossNetV.Last()->Mode2)));
+  }
+  CrossOffV.Add(Off);
+  // neighbor vectors of each mode that belong to the crossnets in the view
+  NbrSlotVV.Gen(ModeIdV.Len());
+  for (int64 c = 0; c < CrossIdV.Len(); c++) {
+    const TCrossNet& CrossNet = *CrossNetV[c];
+    const TStr CrossName = Net->GetCrossName(CrossIdV[c]);
+    const int64 SrcModeN = CrossModeNV[c].Val1, DstModeN = CrossModeNV[c].Val2;
+    const TModeNet& SrcMode = *ModeNetV[SrcModeN];
+    const TModeNet& DstMode = *ModeNetV[DstModeN];
+    const bool SameMode = SrcModeN == DstModeN, IsDir = CrossNet.IsDirect;
+    const TStr SrcName = SrcMode.GetNeighborCrossName(CrossName, true, SameMode, IsDir);
+    const TStr DstName = DstMode.GetNeighborCrossName(CrossName, false, SameMode, IsDir);
+    if (SameMode && !IsDir) {
+      if (SrcMode.KeyToIndexTypeN.IsKey(SrcName)) {
+        NbrSlotVV[SrcModeN].Add(TNbrSlot(c, SrcMode.KeyToIndexTypeN.GetDat(SrcName).Val2, DstModeN, 2, true, true));
+      }
+      continue;
+    }
+    if (SrcMode.KeyToIndexTypeN.IsKey(SrcName)) {
+      NbrSlotVV[SrcModeN].Add(TNbrSlot(c, SrcMode.KeyToIndexTypeN.GetDat(SrcName).Val2, DstModeN, 0, true, !IsDir));
+    }
+    if (DstMode.KeyToIndexTypeN.IsKey(DstName)) {
+      NbrSlotVV[DstModeN].Add(TNbrSlot(c, DstMode.KeyToIndexTypeN.GetDat(DstName).Val2, SrcModeN, 1, !IsDir, true));
+    }
+  }
+}
+
+bool TMMNetView::HasFlag(const TGraphFlag& Flag) const {
+  return HasGraphFlag(TMMNetView::TNet, Flag);
+}
+
+void TMMNetView::NextNode(int64& ModeN, int64& KeyId) const {
+  while (ModeN < ModeNetV.Len()) {
+    if (ModeNetV[ModeN]->NodeH.FNextKeyId(KeyId)) { return; }
+    ModeN++;  KeyId = -1;
+  }
+  KeyId = -1;
+}
+
+void TMMNetView::NextEdge(int64& CrossN, int64& KeyId) const {
+  while (CrossN < CrossNetV.Len()) {
+    if (CrossNetV[CrossN]->CrossH.FNextKeyId(KeyId)) { return; }
+    CrossN++;  KeyId = -1;
+  }
+  KeyId = -1;
+}
+
+int64 TMMNetView::GetNbrDeg(const int64& ModeN, const int64& KeyId, const bool& IsOut) const {
+  const TVec<TNbrSlot, int64>& SlotV = NbrSlotVV[ModeN];
+  int64 Deg = 0;
+  for (int64 s = 0; s < SlotV.Len(); s++) {
+    if (IsOut ? SlotV[s].IsOut : SlotV[s].IsIn) { Deg += GetNbrV(ModeN, KeyId, SlotV[s]).Len(); }
+  }
+  return Deg;
+}
+
+bool TMMNetView::GetNbrEdge(const int64& ModeN, const int64& KeyId, int64 EdgeN, const bool& IsOut, int64& SlotN, int64& LocalEId) const {
+  const TVec<TNbrSlot, int64>& SlotV = NbrSlotVV[ModeN];
+  for (int64 s = 0; s < SlotV.Len(); s++) {
+    if (!(IsOut ? SlotV[s].IsOut : SlotV[s].IsIn)) { continue; }
+    const TInt64V& EIdV = GetNbrV(ModeN, KeyId, SlotV[s]);
+    if (EdgeN < EIdV.Len()) { SlotN = s;  LocalEId = EIdV[EdgeN];  return true; }
+    EdgeN -= EIdV.Len();
+  }
+  return false;
+}
+
+int64 TMMNetView::GetSlotNbrNId(const int64& ModeN, const int64& KeyId, const int64& SlotN, const int64& LocalEId) const {
+  const TNbrSlot& Slot = NbrSlotVV[ModeN][SlotN];
+  const TCrossNet::TCrossEdge& Edge = CrossNetV[Slot.CrossN]->CrossH.GetDat(LocalEId);
+  int64 NbrNId = Slot.NbrEnd == 0 ? Edge.GetDstNId() : Edge.GetSrcNId();
+  if (Slot.NbrEnd == 2 && NbrNId == ModeNetV[ModeN]->NodeH.GetKey(KeyId)) { NbrNId = Edge.GetDstNId(); }
+  return ModeOffV[Slot.NbrModeN] + NbrNId;
+}
+
+int64 TMMNetView::GetNbrNId(const int64& ModeN, const int64& KeyId, const int64& EdgeN, const bool& IsOut) const {
+  int64 SlotN = -1, LocalEId = -1;
+  const bool IsNbr = GetNbrEdge(ModeN, KeyId, EdgeN, IsOut, SlotN, LocalEId);
+  IAssertR(IsNbr, TStr::Fmt("Neighbor %s does not exist.", TInt64::GetStr(EdgeN).CStr()));
+  return GetSlotNbrNId(ModeN, KeyId, SlotN, LocalEId);
+}
+
+int64 TMMNetView::GetNbrEId(const int64& ModeN, const int64& KeyId, const int64& EdgeN, const bool& IsOut) const {
+  int64 SlotN = -1, LocalEId = -1;
+  const bool IsNbr = GetNbrEdge(ModeN, KeyId, EdgeN, IsOut, SlotN, LocalEId);
+  IAssertR(IsNbr, TStr::Fmt("Neighbor %s does not exist.", TInt64::GetStr(EdgeN).CStr()));
+  return CrossOffV[NbrSlotVV[ModeN][SlotN].CrossN] + LocalEId;
+}
+
+int64 TMMNetView::GetCrossNbrDeg(const int64& ModeN, const int64& KeyId, const int64& CrossN) const {
+  const TVec<TNbrSlot, int64>& SlotV = NbrSlotVV[ModeN];
+  int64 Deg = 0;
+  for (int64 s = 0; s < SlotV.Len(); s++) {
+    if (SlotV[s].CrossN == CrossN) { Deg += GetNbrV(ModeN, KeyId, SlotV[s]).Len(); }
+  }
+  return Deg;
+}
+
+bool TMMNetView::GetCrossNbrEdge(const int64& ModeN, const int64& KeyId, const int64& CrossN, int64 EdgeN, int64& SlotN, int64& LocalEId) const {
+  const TVec<TNbrSlot, int64>& SlotV = NbrSlotVV[ModeN];
+  for (int64 s = 0; s < SlotV.Len(); s++) {
+    if (SlotV[s].CrossN != CrossN) { continue; }
+    const TInt64V& EIdV = GetNbrV(ModeN, KeyId, SlotV[s]);
+    if (EdgeN < EIdV.Len()) { SlotN = s;  LocalEId = EIdV[EdgeN];  return true; }
+    EdgeN -= EIdV.Len();
+  }
+  return false;
+}
+
+int64 TMMNetView::GetCrossNbrNId(const int64& ModeN, const int64& KeyId, const int64& CrossN, const int64& EdgeN) const {
+  int64 SlotN = -1, LocalEId = -1;
+  const bool IsNbr = GetCrossNbrEdge(ModeN, KeyId, CrossN, EdgeN, SlotN, LocalEId);
+  IAssertR(IsNbr, TStr::Fmt("Neighbor %s does not exist.", TInt64::GetStr(EdgeN).CStr()));
+  return GetSlotNbrNId(ModeN, KeyId, SlotN, LocalEId);
+}
+
+int64 TMMNetView::GetCrossNbrEId(const int64& ModeN, const int64& KeyId, const int64& CrossN, const int64& EdgeN) const {
+  int64 SlotN = -1, LocalEId = -1;
+  const bool IsNbr = GetCrossNbrEdge(ModeN, KeyId, CrossN, EdgeN, SlotN, LocalEId);
+  IAssertR(IsNbr, TStr::Fmt("Neighbor %s does not exist.", TInt64::GetStr(EdgeN).CStr()));
+  return CrossOffV[CrossN] + LocalEId;
+}
+
+bool TMMNetView::TNodeI::IsInNId(const int64& NId) const {
+  const int64 InDeg = GetInDeg();
+  for (int64 e = 0; e < InDeg; e++) {
+    if (GetInNId(e) == NId) { return true; }
+  }
+  return false;
+}
+
+bool TMMNetView::TNodeI::IsOutNId(const int64& NId) const {
+  const int64 OutDeg = GetOutDeg();
+  for (int64 e = 0; e < OutDeg; e++) {
+    if (GetOutNId(e) == NId) { return true; }
+  }
+  return false;
+}
+
+bool TMMNetView::GetModeNId(const int64& NId, int64& ModeId, int64& ModeNId) const {
+  if (NId < 0 || NId >= GetMxNId()) { return false; }
+  // the last mode whose offset is not larger than NId, skipping empty modes
+  int64 Lo = 0, Hi = ModeIdV.Len();
+  while (Hi - Lo > 1) {
+    const int64 Mid = (Lo + Hi) / 2;
+    if (ModeOffV[Mid] <= NId) { Lo = Mid; } else { Hi = Mid; }
+  }
+  ModeId = ModeIdV[Lo];
+  ModeNId = NId - ModeOffV[Lo];
+  return true;
+}
+
+bool TMMNetView::GetCrossEId(const int64& EId, int64& CrossId, int64& CrossEId) const {
+  if (EId < 0 || EId >= GetMxEId()) { return false; }
+  int64 Lo = 0, Hi = CrossIdV.Len();
+  while (Hi - Lo > 1) {
+    const int64 Mid = (Lo + Hi) / 2;
+    if (CrossOffV[Mid] <= EId) { Lo = Mid; } else { Hi = Mid; }
+  }
+  CrossId = CrossIdV[Lo];
+  CrossEId = EId - CrossOffV[Lo];
+  return true;
+}
+
+int64 TMMNetView::GetNodes() const {
+  int64 Nodes = 0;
+  for (int64 m = 0; m < ModeNetV.Len(); m++) { Nodes += ModeNetV[m]->GetNodes(); }
+  return Nodes;
+}
+
+int64 TMMNetView::GetEdges() const {
+  int64 Edges = 0;
+  for (int64 c = 0; c < CrossNetV.Len(); c++) { Edges += CrossNetV[c]->GetEdges(); }
+  return Edges;
+}
+
+TMMNetView::TNodeI TMMNetView::GetNI(const int64& NId) const {
+  int64 ModeId = -1, ModeNId = -1;
+  const bool IsMode = GetModeNId(NId, ModeId, ModeNId);
+  IAssertR(IsMode, TStr::Fmt("NodeId %s does not exist.", TInt64::GetStr(NId).CStr()));
+  const int64 ModeN = ModeIdToNH.GetDat(ModeId);
+  return TNodeI(this, ModeN, ModeNetV[ModeN]->NodeH.GetKeyId(ModeNId));
+}
+
+TMMNetView::TEdgeI TMMNetView::GetEI(const int64& EId) const {
+  int64 CrossId = -1, CrossEId = -1;
+  const bool IsCross = GetCrossEId(EId, CrossId, CrossEId);
+  IAssertR(IsCross, TStr::Fmt("EdgeId %s does not exist.", TInt64::GetStr(EId).CStr()));
+  const int64 CrossN = CrossIdToNH.GetDat(CrossId);
+  return TEdgeI(this, CrossN, CrossNetV[CrossN]->CrossH.GetKeyId(CrossEId));
+}
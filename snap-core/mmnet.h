@@ -7,6 +7,10 @@ class TMMNet;
 
 typedef TPt<TMMNet> PMMNet;
 
+class TMMNetView;
+
+typedef TPt<TMMNetView> PMMNetView;
+
 ///A single mode in a multimodal directed attributed multigraph
 class TModeNet;
 
@@ -115,6 +119,7 @@ private:
 public:
   friend class TMMNet;
   friend class TCrossNet;
+  friend class TMMNetView;
 };
 
 
@@ -486,6 +491,7 @@ public:
 
   friend class TMMNet;
   friend class TModeNet;
+  friend class TMMNetView;
 };
 
 //#///////////////////////////////////////////////
@@ -560,6 +566,7 @@ private:
 public:
   friend class TCrossNet;
   friend class TModeNet;
+  friend class TMMNetView;
 
 private:
   class TModeNetInit {
@@ -649,6 +656,10 @@ public:
   PMMNet GetSubgraphByCrossNet(TStr64V& CrossNetTypes);
   ///Gets the induced subgraph given a vector of mode type names.
   PMMNet GetSubgraphByModeNet(TStr64V& ModeNetTypes);
+  ///Gets a read-only view of the subgraph given a vector of crossnet type names. No node, edge or attribute data is copied. ##TMMNet::GetSubgraphViewByCrossNet
+  PMMNetView GetSubgraphViewByCrossNet(const TStr64V& CrossNetTypes) const;
+  ///Gets a read-only view of the subgraph given a vector of mode type names. No node, edge or attribute data is copied.
+  PMMNetView GetSubgraphViewByModeNet(const TStr64V& ModeNetTypes) const;
 
   /// Converts multimodal network to TNEANet; as attr names can collide, AttrMap specifies the (Mode/Cross Id, old att name, new attr name)
   PNEANet ToNetwork(TInt64V& CrossNetTypes, TIntStrStrTr64V& NodeAttrMap, TVec<TTriple<TInt64, TStr, TStr>, int64 >& EdgeAttrMap);
@@ -668,9 +679,201 @@ private:
   void GetPartitionRanges(TIntPr64V& Partitions, const TInt64& NumPartitions, const TInt64& MxVal) const;
 };
 
+//#///////////////////////////////////////////////
+/// Read-only view of a subset of the modes and crossnets of a TMMNet. ##TMMNetView::Class
+class TMMNetView {
+public:
+  typedef TMMNetView TNet;
+  typedef TPt<TMMNetView> PNet;
+private:
+  /// A neighbor vector (TIntV node attribute) of a mode that belongs to a crossnet in the view.
+  class TNbrSlot {
+  public:
+    TInt64 CrossN;   ///< Index of the crossnet in the view.
+    TInt64 AttrN;    ///< Index of the neighbor vector in the mode's VecOfIntVecVecsN.
+    TInt64 NbrModeN; ///< Index of the neighboring mode in the view.
+    TInt64 NbrEnd;   ///< Which edge endpoint is the neighbor: 0 destination, 1 source, 2 the other one.
+    TBool IsOut, IsIn;
+  public:
+    TNbrSlot() : CrossN(-1), AttrN(-1), NbrModeN(-1), NbrEnd(-1), IsOut(false), IsIn(false) { }
+    TNbrSlot(const int64& CrossNN, const int64& AttrNN, const int64& NbrModeNN, const int64& NbrEndN, const bool& Out, const bool& In) :
+      CrossN(CrossNN), AttrN(AttrNN), NbrModeN(NbrModeNN), NbrEnd(NbrEndN), IsOut(Out), IsIn(In) { }
+  };
+public:
+  /// Node iterator over the nodes of all the modes in the view. Only forward iteration (operator++) is supported.
+  class TNodeI {
+  private:
+    const TMMNetView *View;
+    int64 ModeN, KeyId;
+  public:
+    TNodeI() : View(NULL), ModeN(0), KeyId(-1) { }
+    TNodeI(const TMMNetView* ViewPt, const int64& ModeNN, const int64& KeyIdN) : View(ViewPt), ModeN(ModeNN), KeyId(KeyIdN) { }
+    TNodeI(const TNodeI& NodeI) : View(NodeI.View), ModeN(NodeI.ModeN), KeyId(NodeI.KeyId) { }
+    TNodeI& operator = (const TNodeI& NodeI) { View=NodeI.View; ModeN=NodeI.ModeN; KeyId=NodeI.KeyId; return *this; }
+    /// Increments the iterator.
+    TNodeI& operator++ (int) { View->NextNode(ModeN, KeyId); return *this; }
+    bool operator < (const TNodeI& NodeI) const { return ModeN < NodeI.ModeN || (ModeN == NodeI.ModeN && KeyId < NodeI.KeyId); }
+    bool operator == (const TNodeI& NodeI) const { return ModeN == NodeI.ModeN && KeyId == NodeI.KeyId; }
+    /// Returns the view-wide ID of the current node.
+    int64 GetId() const { return View->ModeOffV[ModeN] + GetLocalNId(); }
+    /// Returns the ID of the current node within its TModeNet.
+    int64 GetLocalNId() const { return View->ModeNetV[ModeN]->NodeH.GetKey(KeyId); }
+    /// Returns the mode id of the current node.
+    int64 GetModeId() const { return View->ModeIdV[ModeN]; }
+    /// Returns degree of the current node, the sum of in-degree and out-degree.
+    int64 GetDeg() const { return GetInDeg() + GetOutDeg(); }
+    /// Returns in-degree of the current node over all crossnets in the view.
+    int64 GetInDeg() const { return View->GetNbrDeg(ModeN, KeyId, false); }
+    /// Returns out-degree of the current node over all crossnets in the view.
+    int64 GetOutDeg() const { return View->GetNbrDeg(ModeN, KeyId, true); }
+    /// Returns view-wide ID of EdgeN-th in-node (the node pointing to the current node).
+    int64 GetInNId(const int64& EdgeN) const { return View->GetNbrNId(ModeN, KeyId, EdgeN, false); }
+    /// Returns view-wide ID of EdgeN-th out-node (the node the current node points to).
+    int64 GetOutNId(const int64& EdgeN) const { return View->GetNbrNId(ModeN, KeyId, EdgeN, true); }
+    /// Returns view-wide ID of EdgeN-th neighboring node. Out-neighbors are listed first.
+    int64 GetNbrNId(const int64& EdgeN) const { const int64 OutDeg = GetOutDeg(); return EdgeN < OutDeg ? GetOutNId(EdgeN) : GetInNId(EdgeN - OutDeg); }
+    /// Returns view-wide ID of EdgeN-th in-edge.
+    int64 GetInEId(const int64& EdgeN) const { return View->GetNbrEId(ModeN, KeyId, EdgeN, false); }
+    /// Returns view-wide ID of EdgeN-th out-edge.
+    int64 GetOutEId(const int64& EdgeN) const { return View->GetNbrEId(ModeN, KeyId, EdgeN, true); }
+    /// Returns view-wide ID of EdgeN-th in or out-edge.
+    int64 GetNbrEId(const int64& EdgeN) const { const int64 OutDeg = GetOutDeg(); return EdgeN < OutDeg ? GetOutEId(EdgeN) : GetInEId(EdgeN - OutDeg); }
+    /// Tests whether node with view-wide ID NId points to the current node.
+    bool IsInNId(const int64& NId) const;
+    /// Tests whether the current node points to node with view-wide ID NId.
+    bool IsOutNId(const int64& NId) const;
+    /// Tests whether node with view-wide ID NId is a neighbor of the current node.
+    bool IsNbrNId(const int64& NId) const { return IsOutNId(NId) || IsInNId(NId); }
+    /// Returns the number of edges of crossnet CrossId incident to the current node, regardless of their direction.
+    int64 GetCrossNbrDeg(const int64& CrossId) const { return View->GetCrossNbrDeg(ModeN, KeyId, View->CrossIdToNH.GetDat(CrossId)); }
+    /// Returns view-wide ID of EdgeN-th neighboring node over crossnet CrossId.
+    int64 GetCrossNbrNId(const int64& CrossId, const int64& EdgeN) const { return View->GetCrossNbrNId(ModeN, KeyId, View->CrossIdToNH.GetDat(CrossId), EdgeN); }
+    /// Returns view-wide ID of EdgeN-th edge of crossnet CrossId incident to the current node.
+    int64 GetCrossNbrEId(const int64& CrossId, const int64& EdgeN) const { return View->GetCrossNbrEId(ModeN, KeyId, View->CrossIdToNH.GetDat(CrossId), EdgeN); }
+    friend class TMMNetView;
+  };
+  /// Edge iterator over the edges of all the crossnets in the view. Only forward iteration (operator++) is supported.
+  class TEdgeI {
+  private:
+    const TMMNetView *View;
+    int64 CrossN, KeyId;
+  public:
+    TEdgeI() : View(NULL), CrossN(0), KeyId(-1) { }
+    TEdgeI(const TMMNetView* ViewPt, const int64& CrossNN, const int64& KeyIdN) : View(ViewPt), CrossN(CrossNN), KeyId(KeyIdN) { }
+    TEdgeI(const TEdgeI& EdgeI) : View(EdgeI.View), CrossN(EdgeI.CrossN), KeyId(EdgeI.KeyId) { }
+    TEdgeI& operator = (const TEdgeI& EdgeI) { View=EdgeI.View; CrossN=EdgeI.CrossN; KeyId=EdgeI.KeyId; return *this; }
+    /// Increments the iterator.
+    TEdgeI& operator++ (int) { View->NextEdge(CrossN, KeyId); return *this; }
+    bool operator < (const TEdgeI& EdgeI) const { return CrossN < EdgeI.CrossN || (CrossN == EdgeI.CrossN && KeyId < EdgeI.KeyId); }
+    bool operator == (const TEdgeI& EdgeI) const { return CrossN == EdgeI.CrossN && KeyId == EdgeI.KeyId; }
+    /// Returns the view-wide edge ID.
+    int64 GetId() const { return View->CrossOffV[CrossN] + GetLocalEId(); }
+    /// Returns the ID of the edge within its TCrossNet.
+    int64 GetLocalEId() const { return View->CrossNetV[CrossN]->CrossH.GetKey(KeyId); }
+    /// Returns the crossnet id of the edge.
+    int64 GetCrossId() const { return View->CrossIdV[CrossN]; }
+    /// Returns the view-wide ID of the source of the edge.
+    int64 GetSrcNId() const { return View->ModeOffV[View->CrossModeNV[CrossN].Val1] + View->CrossNetV[CrossN]->CrossH[KeyId].GetSrcNId(); }
+    /// Returns the view-wide ID of the destination of the edge.
+    int64 GetDstNId() const { return View->ModeOffV[View->CrossModeNV[CrossN].Val2] + View->CrossNetV[CrossN]->CrossH[KeyId].GetDstNId(); }
+    friend class TMMNetView;
+  };
+public:
+  TCRef CRef;
+private:
+  const TMMNet *Net;
+  TInt64V ModeIdV, CrossIdV;          // mode and crossnet ids in the view
+  TVec<TModeNet*, int64> ModeNetV;    // cached pointers into the parent network
+  TVec<TCrossNet*, int64> CrossNetV;
+  TInt64V ModeOffV, CrossOffV;        // first view-wide node/edge id of each mode/crossnet, the last entry is the total
+  TIntPr64V CrossModeNV;              // (source, destination) mode index of each crossnet
+  TInt64H ModeIdToNH, CrossIdToNH;
+  TVec<TVec<TNbrSlot, int64>, int64> NbrSlotVV; // neighbor vectors of each mode restricted to the view
+private:
+  TMMNetView(const TMMNet* MMNet, const TInt64V& ModeIds, const TInt64V& CrossIds);
+  TMMNetView(const TMMNetView& View);
+  TMMNetView& operator = (const TMMNetView& View);
+  void NextNode(int64& ModeN, int64& KeyId) const;
+  void NextEdge(int64& CrossN, int64& KeyId) const;
+  const TInt64V& GetNbrV(const int64& ModeN, const int64& KeyId, const TNbrSlot& Slot) const {
+    const TVec<TInt64V, int64>& NbrVV = ModeNetV[ModeN]->VecOfIntVecVecsN[Slot.AttrN];
+    return KeyId < NbrVV.Len() ? NbrVV[KeyId] : EmptyV; }
+  int64 GetNbrDeg(const int64& ModeN, const int64& KeyId, const bool& IsOut) const;
+  bool GetNbrEdge(const int64& ModeN, const int64& KeyId, int64 EdgeN, const bool& IsOut, int64& SlotN, int64& LocalEId) const;
+  int64 GetNbrNId(const int64& ModeN, const int64& KeyId, const int64& EdgeN, const bool& IsOut) const;
+  int64 GetNbrEId(const int64& ModeN, const int64& KeyId, const int64& EdgeN, const bool& IsOut) const;
+  int64 GetCrossNbrDeg(const int64& ModeN, const int64& KeyId, const int64& CrossN) const;
+  bool GetCrossNbrEdge(const int64& ModeN, const int64& KeyId, const int64& CrossN, int64 EdgeN, int64& SlotN, int64& LocalEId) const;
+  int64 GetCrossNbrNId(const int64& ModeN, const int64& KeyId, const int64& CrossN, const int64& EdgeN) const;
+  int64 GetCrossNbrEId(const int64& ModeN, const int64& KeyId, const int64& CrossN, const int64& EdgeN) const;
+  int64 GetSlotNbrNId(const int64& ModeN, const int64& KeyId, const int64& SlotN, const int64& LocalEId) const;
+  static const TInt64V EmptyV;
+public:
+  /// Returns a view of the modes ModeIds and crossnets CrossIds of MMNet. Endpoint modes of the crossnets are added automatically.
+  static PMMNetView New(const TMMNet* MMNet, const TInt64V& ModeIds, const TInt64V& CrossIds) { return PMMNetView(new TMMNetView(MMNet, ModeIds, CrossIds)); }
+  /// Returns the network the view refers to.
+  const TMMNet* GetMMNet() const { return Net; }
+  /// Tests whether the view is for a directed graph. Undirected crossnet edges are reported as both in- and out-edges.
+  bool HasFlag(const TGraphFlag& Flag) const;
+
+  /// Returns the number of modes in the view.
+  int64 GetModeNets() const { return ModeIdV.Len(); }
+  /// Returns the number of crossnets in the view.
+  int64 GetCrossNets() const { return CrossIdV.Len(); }
+  /// Returns the ids of the modes in the view.
+  void GetModeIdV(TInt64V& ModeIds) const { ModeIds = ModeIdV; }
+  /// Returns the ids of the crossnets in the view.
+  void GetCrossIdV(TInt64V& CrossIds) const { CrossIds = CrossIdV; }
+  /// Tests whether the mode is part of the view.
+  bool IsModeNet(const TInt64& ModeId) const { return ModeIdToNH.IsKey(ModeId); }
+  /// Tests whether the crossnet is part of the view.
+  bool IsCrossNet(const TInt64& CrossId) const { return CrossIdToNH.IsKey(CrossId); }
+  /// Returns a reference to a modenet in the view.
+  const TModeNet& GetModeNetById(const TInt64& ModeId) const { return *ModeNetV[ModeIdToNH.GetDat(ModeId)]; }
+  /// Returns a reference to a crossnet in the view.
+  const TCrossNet& GetCrossNetById(const TInt64& CrossId) const { return *CrossNetV[CrossIdToNH.GetDat(CrossId)]; }
+
+  /// Returns the view-wide node ID of node NId of mode ModeId.
+  int64 GetNId(const TInt64& ModeId, const int64& NId) const { return ModeOffV[ModeIdToNH.GetDat(ModeId)] + NId; }
+  /// Maps a view-wide node ID back to its mode and the ID within the mode. Returns false if NId is out of range.
+  bool GetModeNId(const int64& NId, int64& ModeId, int64& ModeNId) const;
+  /// Returns the view-wide edge ID of edge EId of crossnet CrossId.
+  int64 GetEId(const TInt64& CrossId, const int64& EId) const { return CrossOffV[CrossIdToNH.GetDat(CrossId)] + EId; }
+  /// Maps a view-wide edge ID back to its crossnet and the ID within the crossnet. Returns false if EId is out of range.
+  bool GetCrossEId(const int64& EId, int64& CrossId, int64& CrossEId) const;
+
+  /// Returns the number of nodes in all the modes of the view.
+  int64 GetNodes() const;
+  /// Returns an ID that is larger than any view-wide node ID.
+  int64 GetMxNId() const { return ModeOffV.Last(); }
+  /// Tests whether view-wide ID NId is a node.
+  bool IsNode(const int64& NId) const { int64 ModeId, ModeNId; return GetModeNId(NId, ModeId, ModeNId) && GetModeNetById(ModeId).IsNode(ModeNId); }
+  /// Returns an iterator referring to the first node in the view.
+  TNodeI BegNI() const { int64 ModeN = 0, KeyId = -1; NextNode(ModeN, KeyId); return TNodeI(this, ModeN, KeyId); }
+  /// Returns an iterator referring to the past-the-end node in the view.
+  TNodeI EndNI() const { return TNodeI(this, ModeIdV.Len(), -1); }
+  /// Returns an iterator referring to the node of view-wide ID NId.
+  TNodeI GetNI(const int64& NId) const;
+  /// Returns the number of edges in all the crossnets of the view.
+  int64 GetEdges() const;
+  /// Returns an ID that is larger than any view-wide edge ID.
+  int64 GetMxEId() const { return CrossOffV.Last(); }
+  /// Tests whether view-wide ID EId is an edge.
+  bool IsEdge(const int64& EId) const { int64 CrossId, CrossEId; return GetCrossEId(EId, CrossId, CrossEId) && GetCrossNetById(CrossId).IsEdge(CrossEId); }
+  /// Returns an iterator referring to the first edge in the view.
+  TEdgeI BegEI() const { int64 CrossN = 0, KeyId = -1; NextEdge(CrossN, KeyId); return TEdgeI(this, CrossN, KeyId); }
+  /// Returns an iterator referring to the past-the-end edge in the view.
+  TEdgeI EndEI() const { return TEdgeI(this, CrossIdV.Len(), -1); }
+  /// Returns an iterator referring to the edge of view-wide ID EId.
+  TEdgeI GetEI(const int64& EId) const;
+  friend class TPt<TMMNetView>;
+};
+
 // set flags
 namespace TSnap {
 template <> struct IsMultiGraph<TModeNet> { enum { Val = 1 }; };
 template <> struct IsDirected<TModeNet> { enum { Val = 1 }; };
+template <> struct IsMultiGraph<TMMNetView> { enum { Val = 1 }; };
+template <> struct IsDirected<TMMNetView> { enum { Val = 1 }; };
 }
 #endif // MMNET_H
@@ -0,0 +1,269 @@
+/*! \file reorder.h
+    \brief Node id compaction and locality-improving node orderings.
+*/
+
+/// Node orderings computed by TSnap::GetNodeOrder().
+typedef enum TNodeOrder_ {
+  noId,       ///< increasing node id, compacts the id space
+  noDegree,   ///< decreasing node degree
+  noBfs,      ///< breadth-first search order, edge directions are ignored
+  noRcm,      ///< reverse Cuthill-McKee, reduces the bandwidth of the adjacency matrix
+  noGorder    ///< Gorder, greedily maximizes shared neighbors within a sliding window
+} TNodeOrder;
+
+/// Main namespace for all the Snap global entities.
+namespace TSnap {
+
+/////////////////////////////////////////////////
+// Node reordering
+//
+// An ordering is a permutation of the nodes given as a vector of node ids,
+// where the node at position i receives the new id i. Apply it with
+// GetRenumberedGraph() to get a graph with ids 0..N-1 whose neighbors are
+// close in memory, which makes MxNId-sized arrays dense and traversals cache-friendly.
+
+/// Returns the nodes of Graph in ordering Order. WinSize is only used by noGorder.
+template<class PGraph> void GetNodeOrder(const PGraph& Graph, const TNodeOrder& Order, TInt64V& NIdV, const int64& WinSize=5);
+/// Returns the nodes of Graph sorted by degree, decreasing if Desc is true.
+template<class PGraph> void GetDegreeNodeOrder(const PGraph& Graph, TInt64V& NIdV, const bool& Desc=true);
+/// Returns the nodes of Graph in breadth-first order starting at StartNId (or the smallest id if -1). Components are visited one after another, edge directions are ignored.
+template<class PGraph> void GetBfsNodeOrder(const PGraph& Graph, TInt64V& NIdV, const int64& StartNId=-1);
+/// Returns the nodes of Graph in reverse Cuthill-McKee order. Edge directions are ignored.
+template<class PGraph> void GetRcmNodeOrder(const PGraph& Graph, TInt64V& NIdV);
+/// Returns the nodes of Graph in Gorder order with window size WinSize. Common in-neighbors of nodes with out-degree above HubDeg (sqrt(N) if -1) are not counted.
+template<class PGraph> void GetGorderNodeOrder(const PGraph& Graph, TInt64V& NIdV, const int64& WinSize=5, const int64& HubDeg=-1);
+/// Returns a copy of Graph where node NIdV[i] has id i. NewNIdH maps old node ids to new ones.
+template<class PGraph> PGraph GetRenumberedGraph(const PGraph& Graph, const TInt64V& NIdV, TInt64H& NewNIdH);
+/// Computes the locality of ordering NIdV over the edges of Graph: the average gap and average log2(gap+1) between the positions of edge endpoints, the largest gap (bandwidth) and the fraction of edges with gap at most WinSize.
+template<class PGraph> void GetNodeOrderStat(const PGraph& Graph, const TInt64V& NIdV, const int64& WinSize, double& AvgGap, double& AvgLogGap, int64& MxGap, double& WinEdgeFrac);
+
+/////////////////////////////////////////////////
+// Implementation
+namespace TSnapDetail {
+/// Index-based adjacency of Graph. Nodes are indexed by their position in NIdV (sorted ids).
+/// Out/In hold out- and in-neighbors; for undirected graphs both hold all neighbors.
+template <class PGraph>
+void GetIdxAdj(const PGraph& Graph, TInt64V& NIdV, TInt64V& OutOffV, TInt64V& OutV, TInt64V& InOffV, TInt64V& InV) {
+  Graph->GetNIdV(NIdV);
+  NIdV.Sort();
+  TInt64H NIdxH(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NIdxH.AddDat(NIdV[i], i); }
+  OutOffV.Gen(NIdV.Len()+1);  InOffV.Gen(NIdV.Len()+1);
+  OutV.Clr();  InV.Clr();
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    const typename PGraph::TObj::TNodeI NI = Graph->GetNI(NIdV[i]);
+    for (int64 e = 0; e < NI.GetOutDeg(); e++) { OutV.Add(NIdxH.GetDat(NI.GetOutNId(e))); }
+    for (int64 e = 0; e < NI.GetInDeg(); e++) { InV.Add(NIdxH.GetDat(NI.GetInNId(e))); }
+    OutOffV[i+1] = OutV.Len();
+    InOffV[i+1] = InV.Len();
+  }
+}
+
+/// Breadth-first traversal from Root over out- and in-edges, appends visited nodes to OrderV.
+/// If ByDeg is true, unvisited neighbors of each node are appended in increasing degree order.
+inline void BfsIdxOrder(const int64& Root, const TInt64V& OutOffV, const TInt64V& OutV, const TInt64V& InOffV,
+ const TInt64V& InV, const bool& ByDeg, TBoolV& VisitedV, TInt64V& OrderV) {
+  TIntPr64V NbrV;
+  int64 Head = OrderV.Len();
+  OrderV.Add(Root);  VisitedV[Root] = true;
+  while (Head < OrderV.Len()) {
+    const int64 NIdx = OrderV[Head++];
+    NbrV.Clr(false);
+    for (int64 e = OutOffV[NIdx]; e < OutOffV[NIdx+1]; e++) {
+      const int64 Nbr = OutV[e];
+      if (! VisitedV[Nbr]) { VisitedV[Nbr] = true; NbrV.Add(TInt64Pr(OutOffV[Nbr+1]-OutOffV[Nbr]+InOffV[Nbr+1]-InOffV[Nbr], Nbr)); }
+    }
+    for (int64 e = InOffV[NIdx]; e < InOffV[NIdx+1]; e++) {
+      const int64 Nbr = InV[e];
+      if (! VisitedV[Nbr]) { VisitedV[Nbr] = true; NbrV.Add(TInt64Pr(OutOffV[Nbr+1]-OutOffV[Nbr]+InOffV[Nbr+1]-InOffV[Nbr], Nbr)); }
+    }
+    if (ByDeg) { NbrV.Sort(); }
+    for (int64 n = 0; n < NbrV.Len(); n++) { OrderV.Add(NbrV[n].Val2); }
+  }
+}
+
+/// Max-priority queue over node indices whose keys only change by +1/-1.
+/// Nodes with equal keys are kept in doubly linked lists, so every operation is O(1)
+/// except PopMx(), which is amortized O(1) over a sequence of increments.
+class TUnitHeap {
+private:
+  TInt64V KeyV, PrevV, NextV, HeadV;
+  int64 MxKey;
+private:
+  void Unlink(const int64& NIdx) {
+    if (PrevV[NIdx] != -1) { NextV[PrevV[NIdx]] = NextV[NIdx]; } else { HeadV[KeyV[NIdx]] = NextV[NIdx]; }
+    if (NextV[NIdx] != -1) { PrevV[NextV[NIdx]] = PrevV[NIdx]; }
+  }
+  void Link(const int64& NIdx) {
+    const int64 Key = KeyV[NIdx];
+    if (Key >= HeadV.Len()) { HeadV.Add(-1); }
+    PrevV[NIdx] = -1;  NextV[NIdx] = HeadV[Key];
+    if (HeadV[Key] != -1) { PrevV[HeadV[Key]] = NIdx; }
+    HeadV[Key] = NIdx;
+    if (Key > MxKey) { MxKey = Key; }
+  }
+public:
+  TUnitHeap(const int64& Nodes) : KeyV(Nodes), PrevV(Nodes), NextV(Nodes), HeadV(), MxKey(0) {
+    HeadV.Add(-1);
+    for (int64 i = Nodes-1; i >= 0; i--) { Link(i); }
+  }
+  bool IsIn(const int64& NIdx) const { return KeyV[NIdx] >= 0; }
+  void Inc(const int64& NIdx) { if (IsIn(NIdx)) { Unlink(NIdx); KeyV[NIdx]++; Link(NIdx); } }
+  void Dec(const int64& NIdx) { if (IsIn(NIdx) && KeyV[NIdx] > 0) { Unlink(NIdx); KeyV[NIdx]--; Link(NIdx); } }
+  void Del(const int64& NIdx) { if (IsIn(NIdx)) { Unlink(NIdx); KeyV[NIdx] = -1; } }
+  /// Removes and returns the node with the largest key, -1 if the heap is empty.
+  int64 PopMx() {
+    while (MxKey > 0 && HeadV[MxKey] == -1) { MxKey--; }
+    const int64 NIdx = HeadV[MxKey];
+    if (NIdx != -1) { Del(NIdx); }
+    return NIdx;
+  }
+};
+} // TSnapDetail
+
+template<class PGraph>
+void GetNodeOrder(const PGraph& Graph, const TNodeOrder& Order, TInt64V& NIdV, const int64& WinSize) {
+  switch (Order) {
+    case noId: Graph->GetNIdV(NIdV); NIdV.Sort(); break;
+    case noDegree: GetDegreeNodeOrder(Graph, NIdV, true); break;
+    case noBfs: GetBfsNodeOrder(Graph, NIdV); break;
+    case noRcm: GetRcmNodeOrder(Graph, NIdV); break;
+    case noGorder: GetGorderNodeOrder(Graph, NIdV, WinSize); break;
+    default: FailR(TStr::Fmt("Unknown node order %d.", int(Order)).CStr());
+  }
+}
+
+template<class PGraph>
+void GetDegreeNodeOrder(const PGraph& Graph, TInt64V& NIdV, const bool& Desc) {
+  TIntPr64V DegNIdV(Graph->GetNodes(), 0);
+  for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    // ties are broken by increasing node id in both directions
+    DegNIdV.Add(TInt64Pr(Desc ? -NI.GetDeg() : NI.GetDeg(), NI.GetId()));
+  }
+  DegNIdV.Sort();
+  NIdV.Gen(DegNIdV.Len(), 0);
+  for (int64 i = 0; i < DegNIdV.Len(); i++) { NIdV.Add(DegNIdV[i].Val2); }
+}
+
+template<class PGraph>
+void GetBfsNodeOrder(const PGraph& Graph, TInt64V& NIdV, const int64& StartNId) {
+  TInt64V IdV, OutOffV, OutV, InOffV, InV, OrderV;
+  TSnapDetail::GetIdxAdj(Graph, IdV, OutOffV, OutV, InOffV, InV);
+  TBoolV VisitedV(IdV.Len());
+  OrderV.Reserve(IdV.Len());
+  if (StartNId != -1) {
+    const int64 Root = IdV.SearchBin(StartNId);
+    IAssertR(Root != -1, TStr::Fmt("Node %s does not exist.", TInt64::GetStr(StartNId).CStr()));
+    TSnapDetail::BfsIdxOrder(Root, OutOffV, OutV, InOffV, InV, false, VisitedV, OrderV);
+  }
+  for (int64 i = 0; i < IdV.Len(); i++) {
+    if (! VisitedV[i]) { TSnapDetail::BfsIdxOrder(i, OutOffV, OutV, InOffV, InV, false, VisitedV, OrderV); }
+  }
+  NIdV.Gen(OrderV.Len());
+  for (int64 i = 0; i < OrderV.Len(); i++) { NIdV[i] = IdV[OrderV[i]]; }
+}
+
+template<class PGraph>
+void GetRcmNodeOrder(const PGraph& Graph, TInt64V& NIdV) {
+  TInt64V IdV, OutOffV, OutV, InOffV, InV, OrderV;
+  TSnapDetail::GetIdxAdj(Graph, IdV, OutOffV, OutV, InOffV, InV);
+  const int64 Nodes = IdV.Len();
+  // each component is started from its node of minimum degree
+  TIntPr64V DegV(Nodes, 0);
+  for (int64 i = 0; i < Nodes; i++) { DegV.Add(TInt64Pr(OutOffV[i+1]-OutOffV[i]+InOffV[i+1]-InOffV[i], i)); }
+  DegV.Sort();
+  TBoolV VisitedV(Nodes);
+  OrderV.Reserve(Nodes);
+  for (int64 i = 0; i < Nodes; i++) {
+    if (! VisitedV[DegV[i].Val2]) { TSnapDetail::BfsIdxOrder(DegV[i].Val2, OutOffV, OutV, InOffV, InV, true, VisitedV, OrderV); }
+  }
+  NIdV.Gen(Nodes);
+  for (int64 i = 0; i < Nodes; i++) { NIdV[i] = IdV[OrderV[Nodes-1-i]]; }
+}
+
+template<class PGraph>
+void GetGorderNodeOrder(const PGraph& Graph, TInt64V& NIdV, const int64& WinSize, const int64& HubDeg) {
+  TInt64V IdV, OutOffV, OutV, InOffV, InV;
+  TSnapDetail::GetIdxAdj(Graph, IdV, OutOffV, OutV, InOffV, InV);
+  const int64 Nodes = IdV.Len();
+  const int64 MxHubDeg = HubDeg == -1 ? (int64) sqrt((double) Nodes) : HubDeg;
+  NIdV.Gen(Nodes, 0);
+  if (Nodes == 0) { return; }
+  TSnapDetail::TUnitHeap Heap(Nodes);
+  TInt64V OrderV(Nodes, 0);
+  // start from the node with the largest in-degree
+  int64 Start = 0;
+  for (int64 i = 1; i < Nodes; i++) {
+    if (InOffV[i+1]-InOffV[i] > InOffV[Start+1]-InOffV[Start]) { Start = i; }
+  }
+  Heap.Del(Start);
+  OrderV.Add(Start);
+  while (OrderV.Len() < Nodes) {
+    // update scores for the node entering and the node leaving the window
+    for (int Step = 0; Step < 2; Step++) {
+      const int64 Pos = Step == 0 ? OrderV.Len()-1 : OrderV.Len()-1-WinSize;
+      if (Pos < 0) { continue; }
+      const int64 NIdx = OrderV[Pos];
+      for (int64 e = OutOffV[NIdx]; e < OutOffV[NIdx+1]; e++) {
+        if (Step == 0) { Heap.Inc(OutV[e]); } else { Heap.Dec(OutV[e]); }
+      }
+      for (int64 e = InOffV[NIdx]; e < InOffV[NIdx+1]; e++) {
+        const int64 Src = InV[e];
+        if (Step == 0) { Heap.Inc(Src); } else { Heap.Dec(Src); }
+        if (OutOffV[Src+1]-OutOffV[Src] > MxHubDeg) { continue; }
+        // siblings share the in-neighbor Src with NIdx
+        for (int64 s = OutOffV[Src]; s < OutOffV[Src+1]; s++) {
+          if (OutV[s] == NIdx) { continue; }
+          if (Step == 0) { Heap.Inc(OutV[s]); } else { Heap.Dec(OutV[s]); }
+        }
+      }
+    }
+    OrderV.Add(Heap.PopMx());
+  }
+  for (int64 i = 0; i < Nodes; i++) { NIdV.Add(IdV[OrderV[i]]); }
+}
+
+template<class PGraph>
+PGraph GetRenumberedGraph(const PGraph& Graph, const TInt64V& NIdV, TInt64H& NewNIdH) {
+  typedef typename PGraph::TObj TGraph;
+  const bool IsDir = IsDirected<TGraph>::Val;
+  IAssertR(NIdV.Len() == Graph->GetNodes(), "Node order must contain every node exactly once.");
+  NewNIdH.Clr(false);
+  NewNIdH.Gen(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NewNIdH.AddDat(NIdV[i], i); }
+  IAssertR(NewNIdH.Len() == NIdV.Len(), "Node order contains duplicate nodes.");
+  PGraph NewGraph = TGraph::New(NIdV.Len(), Graph->GetEdges());
+  for (int64 i = 0; i < NIdV.Len(); i++) { NewGraph->AddNode(i); }
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    const typename TGraph::TNodeI NI = Graph->GetNI(NIdV[i]);
+    for (int64 e = 0; e < NI.GetOutDeg(); e++) {
+      const int64 Dst = NewNIdH.GetDat(NI.GetOutNId(e));
+      if (IsDir || i <= Dst) { NewGraph->AddEdgeUnchecked(i, Dst); }
+    }
+  }
+  NewGraph->SortNodeAdjV();
+  return NewGraph;
+}
+
+template<class PGraph>
+void GetNodeOrderStat(const PGraph& Graph, const TInt64V& NIdV, const int64& WinSize, double& AvgGap, double& AvgLogGap, int64& MxGap, double& WinEdgeFrac) {
+  typedef typename PGraph::TObj TGraph;
+  TInt64H PosH(NIdV.Len());
+  for (int64 i = 0; i < NIdV.Len(); i++) { PosH.AddDat(NIdV[i], i); }
+  double GapSum = 0.0, LogGapSum = 0.0;
+  int64 Edges = 0, WinEdges = 0;
+  MxGap = 0;
+  for (typename TGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+    const int64 Gap = TInt64::Abs(PosH.GetDat(EI.GetSrcNId()) - PosH.GetDat(EI.GetDstNId()));
+    GapSum += double(Gap);
+    LogGapSum += TMath::Log2(double(Gap+1));
+    if (Gap > MxGap) { MxGap = Gap; }
+    if (Gap <= WinSize) { WinEdges++; }
+    Edges++;
+  }
+  AvgGap = Edges > 0 ? GapSum / double(Edges) : 0.0;
+  AvgLogGap = Edges > 0 ? LogGapSum / double(Edges) : 0.0;
+  WinEdgeFrac = Edges > 0 ? double(WinEdges) / double(Edges) : 0.0;
+}
+
+} // namespace TSnap
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// Random graph with scattered node ids and some runs of consecutive neighbors
+template <class PGraph>
+PGraph GetTestCompGraph(const int& NNodes, const int& NEdges) {
+  PGraph Graph = PGraph::TObj::New();
+  TRnd Rnd(1);
+  for (int i = 0; i < NNodes; i++) {
+    Graph->AddNode(5*i + 2);
+  }
+  for (int i = 0; i < NEdges; i++) {
+    Graph->AddEdge(5*Rnd.GetUniDevInt(NNodes) + 2, 5*Rnd.GetUniDevInt(NNodes) + 2);
+  }
+  for (int i = 0; i < 20; i++) {
+    Graph->AddEdge(2, 5*i + 2);
+  }
+  return Graph;
+}
+
+template <class PGraph>
+void CheckCompGraph(const PGraph& Graph, const PCompGraph& CompGraph) {
+  EXPECT_EQ(Graph->GetNodes(), CompGraph->GetNodes());
+  EXPECT_EQ(Graph->GetEdges(), CompGraph->GetEdges());
+  EXPECT_EQ(Graph->GetMxNId(), CompGraph->GetMxNId());
+  for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    TCompGraph::TNodeI CI = CompGraph->GetNI(NI.GetId());
+    EXPECT_EQ(NI.GetId(), CI.GetId());
+    ASSERT_EQ(NI.GetOutDeg(), CI.GetOutDeg());
+    ASSERT_EQ(NI.GetInDeg(), CI.GetInDeg());
+    for (int64 e = 0; e < NI.GetOutDeg(); e++) {
+      EXPECT_EQ(NI.GetOutNId(e), CI.GetOutNId(e));
+    }
+    for (int64 e = 0; e < NI.GetInDeg(); e++) {
+      EXPECT_EQ(NI.GetInNId(e), CI.GetInNId(e));
+    }
+  }
+  int64 Edges = 0;
+  for (TCompGraph::TEdgeI EI = CompGraph->BegEI(); EI < CompGraph->EndEI(); EI++) {
+    EXPECT_TRUE(Graph->IsEdge(EI.GetSrcNId(), EI.GetDstNId()));
+    EXPECT_TRUE(CompGraph->IsEdge(EI.GetSrcNId(), EI.GetDstNId()));
+    Edges++;
+  }
+  EXPECT_EQ(Graph->GetEdges(), Edges);
+}
+
+// Test conversion of undirected and directed graphs
+TEST(TCompGraph, ConvertGraphs) {
+  PUNGraph UGraph = GetTestCompGraph<PUNGraph>(1000, 5000);
+  PNGraph Graph = GetTestCompGraph<PNGraph>(1000, 5000);
+  // with and without interval compression
+  for (int MnIntervalLen = 0; MnIntervalLen <= 3; MnIntervalLen += 3) {
+    PCompGraph CompUGraph = TCompGraph::New(UGraph, MnIntervalLen);
+    EXPECT_FALSE(CompUGraph->IsDirected());
+    CheckCompGraph(UGraph, CompUGraph);
+    PCompGraph CompGraph = TCompGraph::New(Graph, MnIntervalLen);
+    EXPECT_TRUE(CompGraph->IsDirected());
+    CheckCompGraph(Graph, CompGraph);
+    // gaps of a random graph with 1000 nodes fit in two bytes
+    EXPECT_LT(CompGraph->GetEdgeBytes(), 2*(Graph->GetEdges()*2 + 2*Graph->GetNodes()));
+  }
+  EXPECT_FALSE(TCompGraph::New(Graph)->IsEdge(2, 1));
+  EXPECT_FALSE(TCompGraph::New(Graph)->IsNode(3));
+
+  PCompGraph CompGraph = TCompGraph::New(TNGraph::New());
+  EXPECT_EQ(0, CompGraph->GetNodes());
+  EXPECT_TRUE(CompGraph->BegEI() == CompGraph->EndEI());
+}
+
+// Test conversion of a big network
+TEST(TCompGraph, ConvertBigNet) {
+  typedef TBigNet<TInt, true> TBNet;
+  PNGraph Graph = GetTestCompGraph<PNGraph>(100, 500);
+  TPt<TBNet> BigNet = TBNet::New(Graph->GetNodes(), Graph->GetEdges());
+  for (TNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    BigNet->AddNode(NI.GetId(), NI.GetInDeg(), NI.GetOutDeg());
+  }
+  for (TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+    BigNet->AddEdge(EI.GetSrcNId(), EI.GetDstNId());
+  }
+  PCompGraph CompGraph = TCompGraph::New(BigNet);
+  CheckCompGraph(Graph, CompGraph);
+}
+
+// Test saving and loading
+TEST(TCompGraph, SaveLoad) {
+  PNGraph Graph = GetTestCompGraph<PNGraph>(1000, 5000);
+  PCompGraph CompGraph = TCompGraph::New(Graph);
+  {
+    TFOut FOut("test.compgraph");
+    CompGraph->Save(FOut);
+  }
+  {
+    TFIn FIn("test.compgraph");
+    CheckCompGraph(Graph, TCompGraph::Load(FIn));
+  }
+  TShMIn ShMIn("test.compgraph");
+  CheckCompGraph(Graph, TCompGraph::LoadShM(ShMIn));
+  ShMIn.CloseMapping();
+}
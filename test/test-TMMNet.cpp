@@ -292,3 +292,104 @@ TEST(TMMNet, CrossNetI) {
     }
     EXPECT_EQ(10, i);
 }
+
+TEST(TMMNet, GetSubgraphViewByCrossNet) {
+  PMMNet Net = TMMNet::New();
+  Net->AddModeNet("User");
+  Net->AddModeNet("Item");
+  Net->AddModeNet("Tag");
+  Net->AddCrossNet("User", "Item", "Buys");
+  Net->AddCrossNet("User", "User", "Follows");
+  Net->AddCrossNet("Item", "Tag", "Tagged", false);
+  TModeNet& Users = Net->GetModeNetByName("User");
+  TModeNet& Items = Net->GetModeNetByName("Item");
+  TModeNet& Tags = Net->GetModeNetByName("Tag");
+  for (int i = 0; i < 3; i++) { Users.AddNode(i); Items.AddNode(i); Tags.AddNode(i); }
+  TCrossNet& Buys = Net->GetCrossNetByName("Buys");
+  Buys.AddEdge(0, 1);
+  Buys.AddEdge(0, 2);
+  Buys.AddEdge(1, 2);
+  TCrossNet& Follows = Net->GetCrossNetByName("Follows");
+  Follows.AddEdge(0, 1);
+  Follows.AddEdge(2, 0);
+  TCrossNet& Tagged = Net->GetCrossNetByName("Tagged");
+  Tagged.AddEdge(1, 0);
+
+  TStr64V CrossNets;
+  CrossNets.Add("Buys");
+  CrossNets.Add("Follows");
+  PMMNetView View = Net->GetSubgraphViewByCrossNet(CrossNets);
+  EXPECT_EQ(2, View->GetModeNets());
+  EXPECT_EQ(2, View->GetCrossNets());
+  EXPECT_FALSE(View->IsModeNet(Net->GetModeId("Tag")));
+  EXPECT_EQ(6, View->GetNodes());
+  EXPECT_EQ(5, View->GetEdges());
+  EXPECT_TRUE(View->HasFlag(gfDirected));
+
+  int64 Nodes = 0, Edges = 0;
+  for (TMMNetView::TNodeI NI = View->BegNI(); NI < View->EndNI(); NI++) {
+    Nodes++;
+    Edges += NI.GetOutDeg();
+    EXPECT_TRUE(View->IsNode(NI.GetId()));
+    EXPECT_EQ(NI.GetId(), View->GetNId(NI.GetModeId(), NI.GetLocalNId()));
+  }
+  EXPECT_EQ(6, Nodes);
+  EXPECT_EQ(5, Edges);
+
+  const int64 User0 = View->GetNId(Net->GetModeId("User"), 0);
+  TMMNetView::TNodeI NI = View->GetNI(User0);
+  EXPECT_EQ(3, NI.GetOutDeg());
+  EXPECT_EQ(1, NI.GetInDeg());
+  EXPECT_TRUE(NI.IsOutNId(View->GetNId(Net->GetModeId("Item"), 2)));
+  EXPECT_TRUE(NI.IsOutNId(View->GetNId(Net->GetModeId("User"), 1)));
+  EXPECT_TRUE(NI.IsInNId(View->GetNId(Net->GetModeId("User"), 2)));
+  EXPECT_FALSE(NI.IsInNId(View->GetNId(Net->GetModeId("Item"), 1)));
+
+  const int64 Item2 = View->GetNId(Net->GetModeId("Item"), 2);
+  EXPECT_EQ(0, View->GetNI(Item2).GetOutDeg());
+  EXPECT_EQ(2, View->GetNI(Item2).GetInDeg());
+
+  int64 ModeId, ModeNId;
+  EXPECT_TRUE(View->GetModeNId(Item2, ModeId, ModeNId));
+  EXPECT_EQ(Net->GetModeId("Item"), ModeId);
+  EXPECT_EQ(2, ModeNId);
+
+  for (TMMNetView::TEdgeI EI = View->BegEI(); EI < View->EndEI(); EI++) {
+    EXPECT_TRUE(View->GetNI(EI.GetSrcNId()).IsOutNId(EI.GetDstNId()));
+    EXPECT_TRUE(View->GetNI(EI.GetDstNId()).IsInNId(EI.GetSrcNId()));
+    EXPECT_EQ(EI.GetId(), View->GetEI(EI.GetId()).GetId());
+  }
+}
+
+TEST(TMMNet, GetSubgraphViewByModeNet) {
+  PMMNet Net = TMMNet::New();
+  Net->AddModeNet("Item");
+  Net->AddModeNet("Tag");
+  Net->AddModeNet("User");
+  Net->AddCrossNet("Item", "Tag", "Tagged", false);
+  Net->AddCrossNet("User", "Item", "Buys");
+  TModeNet& Items = Net->GetModeNetByName("Item");
+  TModeNet& Tags = Net->GetModeNetByName("Tag");
+  Items.AddNode(0);
+  Items.AddNode(1);
+  Tags.AddNode(5);
+  Net->GetModeNetByName("User").AddNode(0);
+  Net->GetCrossNetByName("Tagged").AddEdge(0, 5);
+  Net->GetCrossNetByName("Tagged").AddEdge(1, 5);
+  Net->GetCrossNetByName("Buys").AddEdge(0, 1);
+
+  TStr64V Modes;
+  Modes.Add("Item");
+  Modes.Add("Tag");
+  PMMNetView View = Net->GetSubgraphViewByModeNet(Modes);
+  EXPECT_EQ(2, View->GetModeNets());
+  EXPECT_EQ(1, View->GetCrossNets());
+  EXPECT_EQ(3, View->GetNodes());
+  EXPECT_EQ(2, View->GetEdges());
+  // undirected crossnet edges are both in- and out-edges
+  TMMNetView::TNodeI NI = View->GetNI(View->GetNId(Net->GetModeId("Tag"), 5));
+  EXPECT_EQ(2, NI.GetOutDeg());
+  EXPECT_EQ(2, NI.GetInDeg());
+  EXPECT_TRUE(NI.IsNbrNId(View->GetNId(Net->GetModeId("Item"), 1)));
+  EXPECT_EQ(1, View->GetNI(View->GetNId(Net->GetModeId("Item"), 1)).GetOutDeg());
+}
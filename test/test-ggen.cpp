@@ -887,3 +887,28 @@ TEST(GGenTest, GenRMat) {
     
   } // end loop - NNodes
 }
+
+// Test parallel generation of RMat edges
+TEST(GGenTest, GenParRMat) {
+  const int NNodes = 1000;
+  const int64 NEdges = 20000;
+  TVec<TIntPr, int64> EdgeV, EdgeV2;
+  TRnd Rnd(1), Rnd2(1);
+  TSnap::GenRMatEdges(NNodes, NEdges, 0.4, 0.2, 0.2, EdgeV, Rnd);
+  TSnap::GenRMatEdges(NNodes, NEdges, 0.4, 0.2, 0.2, EdgeV2, Rnd2);
+  // exact number of edges, sorted, no duplicates and no self loops
+  EXPECT_EQ(NEdges, EdgeV.Len());
+  for (int64 e = 0; e < EdgeV.Len(); e++) {
+    EXPECT_NE(EdgeV[e].Val1, EdgeV[e].Val2);
+    EXPECT_TRUE(EdgeV[e].Val1 >= 0 && EdgeV[e].Val1 < NNodes);
+    EXPECT_TRUE(EdgeV[e].Val2 >= 0 && EdgeV[e].Val2 < NNodes);
+    if (e > 0) { EXPECT_TRUE(EdgeV[e-1] < EdgeV[e]); }
+  }
+  // same random seed gives the same edges
+  EXPECT_TRUE(EdgeV == EdgeV2);
+
+  PNGraph Graph = TSnap::GenParRMat(NNodes, NEdges, 0.4, 0.2, 0.2);
+  EXPECT_TRUE(Graph->IsOk());
+  EXPECT_EQ(NNodes, Graph->GetNodes());
+  EXPECT_EQ(NEdges, Graph->GetEdges());
+}
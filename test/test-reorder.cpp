@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// A path 0-1-...-NNodes-1 whose node ids are scattered over a large id space
+PUNGraph GetScatteredPath(const int& NNodes, TInt64V& PathNIdV) {
+  PUNGraph Graph = TUNGraph::New();
+  TRnd Rnd(1);
+  PathNIdV.Clr();
+  for (int i = 0; i < NNodes; i++) {
+    PathNIdV.Add(1000*i + 7);
+  }
+  PathNIdV.Shuffle(Rnd);
+  for (int i = 0; i < NNodes; i++) {
+    Graph->AddNode(PathNIdV[i]);
+  }
+  for (int i = 1; i < NNodes; i++) {
+    Graph->AddEdge(PathNIdV[i-1], PathNIdV[i]);
+  }
+  return Graph;
+}
+
+template <class PGraph>
+void CheckPermutation(const PGraph& Graph, const TInt64V& NIdV) {
+  EXPECT_EQ(Graph->GetNodes(), NIdV.Len());
+  TInt64H NIdH;
+  for (int64 i = 0; i < NIdV.Len(); i++) {
+    EXPECT_TRUE(Graph->IsNode(NIdV[i]));
+    NIdH.AddKey(NIdV[i]);
+  }
+  EXPECT_EQ(Graph->GetNodes(), NIdH.Len());
+}
+
+// Test that all orderings are permutations and renumbering preserves the graph
+TEST(reorder, TestNodeOrders) {
+  PNGraph Graph = TNGraph::New();
+  TRnd Rnd(1);
+  for (int i = 0; i < 200; i++) {
+    Graph->AddNode(3*i + 1);
+  }
+  for (int i = 0; i < 1000; i++) {
+    Graph->AddEdge(3*Rnd.GetUniDevInt(200) + 1, 3*Rnd.GetUniDevInt(200) + 1);
+  }
+  const TNodeOrder OrderV[] = {noId, noDegree, noBfs, noRcm, noGorder};
+  for (int o = 0; o < 5; o++) {
+    TInt64V NIdV;
+    TSnap::GetNodeOrder(Graph, OrderV[o], NIdV);
+    CheckPermutation(Graph, NIdV);
+
+    TInt64H NewNIdH;
+    PNGraph Graph2 = TSnap::GetRenumberedGraph(Graph, NIdV, NewNIdH);
+    EXPECT_EQ(Graph->GetNodes(), Graph2->GetNodes());
+    EXPECT_EQ(Graph->GetEdges(), Graph2->GetEdges());
+    EXPECT_EQ(Graph->GetNodes(), Graph2->GetMxNId());
+    for (TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+      const int64 Src = NewNIdH.GetDat(EI.GetSrcNId());
+      const int64 Dst = NewNIdH.GetDat(EI.GetDstNId());
+      EXPECT_EQ(EI.GetSrcNId(), NIdV[Src]);
+      EXPECT_TRUE(Graph2->IsEdge(Src, Dst));
+    }
+  }
+
+  TInt64V NIdV;
+  TSnap::GetDegreeNodeOrder(Graph, NIdV);
+  for (int64 i = 1; i < NIdV.Len(); i++) {
+    EXPECT_GE(Graph->GetNI(NIdV[i-1]).GetDeg(), Graph->GetNI(NIdV[i]).GetDeg());
+  }
+}
+
+// Test that BFS, RCM and Gorder recover the locality of a scrambled path
+TEST(reorder, TestNodeOrderStat) {
+  const int NNodes = 500;
+  TInt64V PathNIdV, NIdV;
+  PUNGraph Graph = GetScatteredPath(NNodes, PathNIdV);
+  double AvgGap, AvgLogGap, WinEdgeFrac;
+  int64 MxGap;
+
+  TSnap::GetNodeOrder(Graph, noId, NIdV);
+  TSnap::GetNodeOrderStat(Graph, NIdV, 5, AvgGap, AvgLogGap, MxGap, WinEdgeFrac);
+  EXPECT_GT(MxGap, 5);
+  EXPECT_LT(WinEdgeFrac, 0.5);
+
+  const TNodeOrder OrderV[] = {noBfs, noRcm};
+  for (int o = 0; o < 2; o++) {
+    TSnap::GetNodeOrder(Graph, OrderV[o], NIdV);
+    CheckPermutation(Graph, NIdV);
+    TSnap::GetNodeOrderStat(Graph, NIdV, 5, AvgGap, AvgLogGap, MxGap, WinEdgeFrac);
+    EXPECT_LE(MxGap, 2);
+    EXPECT_EQ(1.0, WinEdgeFrac);
+  }
+
+  // Gorder may restart once the window runs off the end of the path
+  TSnap::GetNodeOrder(Graph, noGorder, NIdV);
+  CheckPermutation(Graph, NIdV);
+  TSnap::GetNodeOrderStat(Graph, NIdV, 5, AvgGap, AvgLogGap, MxGap, WinEdgeFrac);
+  EXPECT_GT(WinEdgeFrac, 0.9);
+
+  TSnap::GetBfsNodeOrder(Graph, NIdV, PathNIdV[0]);
+  for (int i = 0; i < NNodes; i++) {
+    EXPECT_EQ(PathNIdV[i], NIdV[i]);
+  }
+}
@@ -117,6 +117,109 @@ TEST(SHMTest, LoadTNeanet) {
   checkTNEANetCorrect(G, G2);
 }
 
+template <class PGraph>
+void CheckMMapGraphCorrect(PGraph Saved, PMMapGraph Loaded) {
+  EXPECT_EQ(Saved->GetNodes(), Loaded->GetNodes());
+  EXPECT_EQ(Saved->GetEdges(), Loaded->GetEdges());
+  for (typename PGraph::TObj::TNodeI NI = Saved->BegNI(); NI < Saved->EndNI(); NI++) {
+    TMMapGraph::TNodeI MI = Loaded->GetNI(NI.GetId());
+    EXPECT_EQ(NI.GetId(), MI.GetId());
+    EXPECT_EQ(NI.GetInDeg(), MI.GetInDeg());
+    EXPECT_EQ(NI.GetOutDeg(), MI.GetOutDeg());
+  }
+  for (typename PGraph::TObj::TEdgeI EI = Saved->BegEI(); EI < Saved->EndEI(); EI++) {
+    EXPECT_TRUE(Loaded->IsEdge(EI.GetSrcNId(), EI.GetDstNId()));
+  }
+  int64 Edges = 0;
+  for (TMMapGraph::TEdgeI EI = Loaded->BegEI(); EI < Loaded->EndEI(); EI++) {
+    EXPECT_TRUE(Saved->IsEdge(EI.GetSrcNId(), EI.GetDstNId()));
+    Edges++;
+  }
+  EXPECT_EQ(Saved->GetEdges(), Edges);
+}
+
+// Tests saving and memory-mapping of graph snapshots
+TEST(SHMTest, MMapGraphs) {
+  TStr Filename("test.graph");
+  PUNGraph UG = WriteGraph<PUNGraph>(Filename);
+  UG->AddEdge(7, 7);
+  TMMapGraph::Save(Filename, UG);
+  CheckMMapGraphCorrect<PUNGraph>(UG, TMMapGraph::Load(Filename));
+
+  PNGraph G = WriteGraph<PNGraph>(Filename);
+  TMMapGraph::Save(Filename, G);
+  PMMapGraph G2 = TMMapGraph::Load(Filename);
+  CheckMMapGraphCorrect<PNGraph>(G, G2);
+  EXPECT_TRUE(G2->IsDirected());
+  EXPECT_FALSE(G2->IsNode(100));
+  EXPECT_TRUE(G2->GetNI(5).IsInNId(4));
+  EXPECT_FALSE(G2->GetNI(5).IsOutNId(7));
+}
+
+// Tests memory-mapping of TNEANet snapshots with int and float attributes
+TEST(SHMTest, MMapTNeanet) {
+  TStr Filename("test.graph");
+  PNEANet G = writeTNEANet(Filename);
+  G->AddIntAttrDatE(0, 42, "weight");
+  G->AddFltAttrDatE(1, 0.5, "prob");
+  TMMapGraph::Save(Filename, G);
+  PMMapGraph G2 = TMMapGraph::Load(Filename);
+  EXPECT_EQ(G->GetNodes(), G2->GetNodes());
+  EXPECT_EQ(G->GetEdges(), G2->GetEdges());
+  EXPECT_TRUE(G2->IsMultiGraph());
+  EXPECT_EQ(G->GetIntAttrDatN(3, "int"), G2->GetIntAttrDatN(G2->GetNI(3), "int"));
+  EXPECT_EQ(G->GetIntAttrDatN(50, "int"), G2->GetIntAttrDatN(G2->GetNI(50), "int"));
+  EXPECT_EQ(G->GetFltAttrDatN(5, "float"), G2->GetFltAttrDatN(G2->GetNI(5), "float"));
+  EXPECT_EQ(G->GetIntAttrDatN(7, "int"), G2->GetIntAttrDatN(G2->GetNI(7), "int"));
+  int64 Edges = 0;
+  for (TMMapGraph::TEdgeI EI = G2->BegEI(); EI < G2->EndEI(); EI++) {
+    const int64 EId = EI.GetId();
+    EXPECT_EQ(G->GetEI(EId).GetSrcNId(), EI.GetSrcNId());
+    EXPECT_EQ(G->GetEI(EId).GetDstNId(), EI.GetDstNId());
+    EXPECT_EQ(G->GetIntAttrDatE(EId, "weight"), G2->GetIntAttrDatE(EI, "weight"));
+    EXPECT_EQ(G->GetFltAttrDatE(EId, "prob"), G2->GetFltAttrDatE(EI, "prob"));
+    Edges++;
+  }
+  EXPECT_EQ(G->GetEdges(), Edges);
+}
+
+// Compares startup time of TShMIn loading and snapshot memory-mapping
+TEST(SHMTest, MMapStartupTime) {
+  const int NNodes = 100000;
+  const int NEdges = 1000000;
+  TRnd Rnd(1);
+  PNGraph G = TNGraph::New(NNodes, NEdges);
+  for (int i = 0; i < NNodes; i++) {
+    G->AddNode(i);
+  }
+  for (int i = 0; i < NEdges; i++) {
+    G->AddEdge(Rnd.GetUniDevInt(NNodes), Rnd.GetUniDevInt(NNodes));
+  }
+  TStr ShMFilename("test.graph");
+  TStr MMapFilename("test.mmg");
+  { TFOut OutStream(ShMFilename); G->Save(OutStream); }
+  TMMapGraph::Save(MMapFilename, G);
+
+  TExeTm ExeTm;
+  TShMIn ShMIn(ShMFilename);
+  PNGraph G1 = TNGraph::LoadShM(ShMIn);
+  const double ShMSecs = ExeTm.GetSecs();
+  ExeTm.Tick();
+  PMMapGraph G2 = TMMapGraph::Load(MMapFilename);
+  const double MMapSecs = ExeTm.GetSecs();
+  printf("Loading %d nodes, %d edges: LoadShM %.4fs, TMMapGraph::Load %.4fs\n",
+    (int) G->GetNodes(), (int) G->GetEdges(), ShMSecs, MMapSecs);
+
+  EXPECT_EQ(G1->GetNodes(), G2->GetNodes());
+  EXPECT_EQ(G1->GetEdges(), G2->GetEdges());
+  int64 OutDegSum = 0;
+  for (TMMapGraph::TNodeI NI = G2->BegNI(); NI < G2->EndNI(); NI++) {
+    OutDegSum += NI.GetOutDeg();
+  }
+  EXPECT_EQ(G1->GetEdges(), OutDegSum);
+  ShMIn.CloseMapping();
+}
+
 template <class PNet>
 void checkNetworkCorrect(PNet Saved, PNet Loaded) {
   EXPECT_EQ(Saved->GetNodes(), Loaded->GetNodes());